@@ -0,0 +1,209 @@
+﻿#pragma once
+#ifndef __BENCH_HARNESS_HPP__
+#define __BENCH_HARNESS_HPP__
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+
+// A small benchmark runner with the command line and JSON layout of Google Benchmark,
+// so the output can be compared with its tools, without the dependency.
+namespace Bench {
+    // keeps the optimizer from dropping a computed value
+    template<typename T>
+    inline void do_not_optimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // passed to every benchmark, the benchmark brackets the measured part of one repetition with start() and stop()
+    class State {
+        std::chrono::steady_clock::time_point begin;
+        double elapsed_ns = 0;
+    public:
+        void start() { begin = std::chrono::steady_clock::now(); }
+        void stop() { elapsed_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count(); }
+        double elapsed() const noexcept { return elapsed_ns; }
+    };
+
+    struct Case {
+        std::string name; // container/key/operation, the size is appended
+        std::string container;
+        std::string baseline; // name of the std:: container the case is compared with
+        std::string key_type;
+        std::string operation;
+        std::function<void(State&, std::size_t size)> run; // one repetition, processes size items
+    };
+
+    struct Options {
+        std::size_t min_size = 100;
+        std::size_t max_size = 1000000;
+        std::vector<std::string> filters; // a case runs if its name contains one of them, all cases run if empty
+        double min_time = 0.05; // seconds of measured time per case
+        double max_time = 2.0; // a case is not run for larger sizes once one repetition takes more than a tenth of it
+        std::string json_path; // "-" writes JSON to standard output
+        bool list_only = false;
+    };
+
+    inline std::size_t parse_size(const std::string& text) {
+        // accepts plain numbers and the 1e6 notation
+        double value = std::stod(text);
+        if (value < 1) throw std::invalid_argument("size must be at least 1: " + text); // EXCEPTION
+        return static_cast<std::size_t>(value + 0.5);
+    }
+
+    inline Options parse_options(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto value = [&arg](const std::string& flag) { return arg.substr(flag.size()); };
+            if (arg.rfind("--min-size=", 0) == 0) options.min_size = parse_size(value("--min-size="));
+            else if (arg.rfind("--max-size=", 0) == 0) options.max_size = parse_size(value("--max-size="));
+            else if (arg.rfind("--benchmark_filter=", 0) == 0) options.filters.push_back(value("--benchmark_filter="));
+            else if (arg.rfind("--filter=", 0) == 0) options.filters.push_back(value("--filter="));
+            else if (arg.rfind("--min-time=", 0) == 0) options.min_time = std::stod(value("--min-time="));
+            else if (arg.rfind("--max-time=", 0) == 0) options.max_time = std::stod(value("--max-time="));
+            else if (arg.rfind("--json=", 0) == 0) options.json_path = value("--json=");
+            else if (arg == "--json") options.json_path = "-";
+            else if (arg == "--list") options.list_only = true;
+            else {
+                std::cerr << "usage: " << argv[0] << " [--min-size=N] [--max-size=N] [--filter=TEXT]... [--min-time=SECONDS] [--max-time=SECONDS] [--json[=PATH]] [--list]\n"
+                    << "sizes are swept in powers of ten from min-size to max-size (1e2..1e8 are accepted), default 1e2..1e6\n";
+                std::exit(arg == "--help" ? 0 : 1);
+            }
+        }
+        if (options.min_size > options.max_size) throw std::invalid_argument("min-size is greater than max-size."); // EXCEPTION
+        return options;
+    }
+
+    struct Result {
+        const Case* benchmark;
+        std::size_t size;
+        std::size_t repetitions;
+        double ns_per_item;
+    };
+
+    inline std::string json_escape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    inline void write_json(std::ostream& out, const std::vector<Result>& results) {
+        std::time_t now = std::time(nullptr);
+        char date[64];
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+        out << "{\n  \"context\": {\n"
+            << "    \"date\": \"" << date << "\",\n"
+            << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+            << "    \"library_build_type\": \"release\"\n"
+#else
+            << "    \"library_build_type\": \"debug\"\n"
+#endif
+            << "  },\n  \"benchmarks\": [\n";
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const Result& r = results[i];
+            std::string name = r.benchmark->name + "/" + std::to_string(r.size);
+            out << "    {\n"
+                << "      \"name\": \"" << json_escape(name) << "\",\n"
+                << "      \"run_name\": \"" << json_escape(name) << "\",\n"
+                << "      \"run_type\": \"iteration\",\n"
+                << "      \"iterations\": " << r.repetitions << ",\n"
+                << "      \"real_time\": " << r.ns_per_item << ",\n"
+                << "      \"cpu_time\": " << r.ns_per_item << ",\n"
+                << "      \"time_unit\": \"ns\",\n"
+                << "      \"items_per_second\": " << (r.ns_per_item > 0 ? 1e9 / r.ns_per_item : 0) << ",\n"
+                << "      \"container\": \"" << json_escape(r.benchmark->container) << "\",\n"
+                << "      \"baseline\": \"" << json_escape(r.benchmark->baseline) << "\",\n"
+                << "      \"key_type\": \"" << json_escape(r.benchmark->key_type) << "\",\n"
+                << "      \"operation\": \"" << json_escape(r.benchmark->operation) << "\",\n"
+                << "      \"size\": " << r.size << "\n"
+                << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+    inline bool selected(const Case& benchmark, const Options& options) {
+        if (options.filters.empty()) return true;
+        for (auto& filter : options.filters) {
+            if (benchmark.name.find(filter) != std::string::npos) return true;
+        }
+        return false;
+    }
+
+    // runs every selected case for every size, a case is repeated until min_time of measured time is collected
+    inline std::vector<Result> run_all(const std::vector<Case>& cases, const Options& options) {
+        std::vector<Result> results;
+        for (auto& benchmark : cases) {
+            if (!selected(benchmark, options)) continue;
+            if (options.list_only) {
+                std::cout << benchmark.name << "\n";
+                continue;
+            }
+            for (std::size_t size = options.min_size; size <= options.max_size; size *= 10) {
+                State state;
+                std::size_t repetitions = 0;
+                double first_wall = 0, wall = 0;
+                auto wall_start = std::chrono::steady_clock::now();
+                do {
+                    benchmark.run(state, size);
+                    repetitions++;
+                    wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+                    if (repetitions == 1) first_wall = wall;
+                    // the untimed setup of a repetition can be much slower than the measured part, so the wall time is bounded too
+                } while (state.elapsed() < options.min_time * 1e9 && wall < options.min_time * 4 && repetitions < 1000000);
+
+                Result result{ &benchmark, size, repetitions, state.elapsed() / (static_cast<double>(size) * repetitions) };
+                results.push_back(result);
+                std::cerr << benchmark.name << "/" << size << "  " << result.ns_per_item << " ns/item  (" << repetitions << " repetitions)\n";
+                // one repetition of the next size takes at least ten times longer
+                if (first_wall * 10 > options.max_time && size <= options.max_size / 10) {
+                    std::cerr << benchmark.name << ": larger sizes skipped, one repetition took " << first_wall << " s at size " << size << "\n";
+                    break;
+                }
+                if (size > options.max_size / 10) break; // the next size would exceed max_size
+            }
+        }
+        return results;
+    }
+
+    inline int report(const std::vector<Result>& results, const Options& options) {
+        if (options.json_path.empty()) {
+            // ratio to the std:: container with the same key type, operation and size
+            std::cout << "name  ns/item  ratio to std\n";
+            for (auto& r : results) {
+                if (r.benchmark->baseline.empty()) continue;
+                for (auto& base : results) {
+                    if (base.size == r.size && base.benchmark->container == r.benchmark->baseline
+                        && base.benchmark->key_type == r.benchmark->key_type && base.benchmark->operation == r.benchmark->operation) {
+                        std::cout << r.benchmark->name << "/" << r.size << "  " << r.ns_per_item << "  " << r.ns_per_item / base.ns_per_item << "\n";
+                    }
+                }
+            }
+        }
+        else if (options.json_path == "-") write_json(std::cout, results);
+        else {
+            std::ofstream out(options.json_path);
+            if (!out) {
+                std::cerr << "cannot open " << options.json_path << "\n";
+                return 1;
+            }
+            write_json(out, results);
+        }
+        return 0;
+    }
+}
+
+#endif // !__BENCH_HARNESS_HPP__
\ No newline at end of file
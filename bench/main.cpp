@@ -0,0 +1,250 @@
+﻿#include <iostream>
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include "BenchHarness.hpp"
+#include "My/Vector.hpp"
+#include "My/List.hpp"
+#include "My/UnrolledList.hpp"
+#include "My/Map.hpp"
+#include "My/Set.hpp"
+#include "My/HashMap.hpp"
+#include "My/HashSet.hpp"
+#include "My/Parallel.hpp"
+
+// Compares My containers with their std:: counterparts for every key type, operation and size,
+// see Bench::parse_options() for the command line
+
+// the i-th key, distinct for distinct i: the multiplication by an odd constant is a bijection,
+// so keys are spread over the whole range in a fixed pseudo-random order
+struct IntKey {
+    using type = int;
+    static constexpr const char* name = "int";
+    static type make(std::uint64_t i) { return static_cast<int>(static_cast<std::uint32_t>(i) * 2654435761u); }
+};
+
+struct U64Key {
+    using type = std::uint64_t;
+    static constexpr const char* name = "uint64";
+    static type make(std::uint64_t i) { return i * 0x9E3779B97F4A7C15ull; }
+};
+
+// fits in the small string buffer
+struct ShortStringKey {
+    using type = std::string;
+    static constexpr const char* name = "short_string";
+    static type make(std::uint64_t i) { return "k" + std::to_string(static_cast<std::uint32_t>(i) * 2654435761u); }
+};
+
+// always allocated, with a long common prefix that makes comparisons expensive
+struct LongStringKey {
+    using type = std::string;
+    static constexpr const char* name = "long_string";
+    static type make(std::uint64_t i) { return "benchmark/long/string/key/with/a/shared/prefix/" + std::to_string(i * 0x9E3779B97F4A7C15ull); }
+};
+
+// keys 0..n-1 are inserted, keys n..2n-1 are the lookup misses; the last generated set is cached
+template<typename Key>
+const std::vector<typename Key::type>& keys_for(std::size_t n, bool miss) {
+    static std::vector<typename Key::type> cached;
+    static std::size_t cached_n = 0;
+    static bool cached_miss = false;
+    if (cached_n != n || cached_miss != miss || cached.size() != n) {
+        cached.clear();
+        cached.shrink_to_fit();
+        cached.reserve(n);
+        std::uint64_t first = miss ? n : 0;
+        for (std::uint64_t i = first; i < first + n; i++) cached.push_back(Key::make(i));
+        cached_n = n;
+        cached_miss = miss;
+    }
+    return cached;
+}
+
+// folds an element into a number so that iteration cannot be optimized away
+inline std::uint64_t checksum(std::uint64_t value) { return value; }
+inline std::uint64_t checksum(int value) { return static_cast<std::uint64_t>(value); }
+inline std::uint64_t checksum(const std::string& value) { return value.size(); }
+template<typename T1, typename T2>
+std::uint64_t checksum(const std::pair<T1, T2>& value) { return checksum(value.first) + checksum(value.second); }
+
+enum class Kind { SEQUENCE, MAP, SET };
+
+template<Kind kind, typename C, typename K>
+void add(C& container, const K& key) {
+    if constexpr (kind == Kind::SEQUENCE) container.push_back(key);
+    else if constexpr (kind == Kind::SET) container.insert(key);
+    else if constexpr (requires { container.try_emplace(key, std::uint64_t(1)); }) container.try_emplace(key, std::uint64_t(1));
+    else container.insert(key, std::uint64_t(1));
+}
+
+template<Kind kind, typename C, typename Key>
+C filled(std::size_t n) {
+    C container;
+    for (auto& key : keys_for<Key>(n, false)) add<kind>(container, key);
+    return container;
+}
+
+template<Kind kind, typename C, typename Key>
+void add_cases(std::vector<Bench::Case>& cases, const std::string& container, const std::string& baseline) {
+    using K = typename Key::type;
+    auto add_case = [&](const std::string& operation, std::function<void(Bench::State&, std::size_t)> run) {
+        cases.push_back({ container + "/" + Key::name + "/" + operation, container, baseline, Key::name, operation, std::move(run) });
+    };
+
+    add_case("insert", [](Bench::State& state, std::size_t n) {
+        auto& keys = keys_for<Key>(n, false);
+        C c;
+        state.start();
+        for (auto& key : keys) add<kind>(c, key);
+        state.stop();
+        Bench::do_not_optimize(c);
+    });
+    if constexpr (kind != Kind::SEQUENCE) {
+        for (bool miss : { false, true }) {
+            add_case(miss ? "lookup_miss" : "lookup_hit", [miss](Bench::State& state, std::size_t n) {
+                C c = filled<kind, C, Key>(n);
+                auto& keys = keys_for<Key>(n, miss);
+                std::size_t hits = 0;
+                state.start();
+                for (auto& key : keys) hits += c.count(key);
+                state.stop();
+                Bench::do_not_optimize(hits);
+            });
+        }
+    }
+    // sequences erase from the back, associative containers by key; My::Map and My::Set have no erase
+    if constexpr (kind == Kind::SEQUENCE) {
+        add_case("erase", [](Bench::State& state, std::size_t n) {
+            C c = filled<kind, C, Key>(n);
+            state.start();
+            for (std::size_t i = 0; i < n; i++) c.pop_back();
+            state.stop();
+            Bench::do_not_optimize(c);
+        });
+        // every second element while walking: the vectors shift their tail on each erase, so --max-time stops them early
+        add_case("erase_alternate", [](Bench::State& state, std::size_t n) {
+            C c = filled<kind, C, Key>(n);
+            state.start();
+            for (auto it = c.begin(); it != c.end();) {
+                it = c.erase(it);
+                if (it != c.end()) ++it;
+            }
+            state.stop();
+            Bench::do_not_optimize(c);
+        });
+    }
+    else if constexpr (requires(C c, const K& key) { c.erase(key); }) {
+        add_case("erase", [](Bench::State& state, std::size_t n) {
+            C c = filled<kind, C, Key>(n);
+            auto& keys = keys_for<Key>(n, false);
+            state.start();
+            for (auto& key : keys) c.erase(key);
+            state.stop();
+            Bench::do_not_optimize(c);
+        });
+    }
+    add_case("iterate", [](Bench::State& state, std::size_t n) {
+        C c = filled<kind, C, Key>(n);
+        std::uint64_t sum = 0;
+        state.start();
+        for (auto& x : c) sum += checksum(x);
+        state.stop();
+        Bench::do_not_optimize(sum);
+    });
+    add_case("copy", [](Bench::State& state, std::size_t n) {
+        C c = filled<kind, C, Key>(n);
+        state.start();
+        C copy(c);
+        Bench::do_not_optimize(copy);
+        state.stop();
+    });
+    add_case("clear", [](Bench::State& state, std::size_t n) {
+        C c = filled<kind, C, Key>(n);
+        state.start();
+        c.clear();
+        state.stop();
+        Bench::do_not_optimize(c);
+    });
+}
+
+template<typename Key>
+void add_key_type(std::vector<Bench::Case>& cases) {
+    using K = typename Key::type;
+    add_cases<Kind::SEQUENCE, My::Vector<K>, Key>(cases, "Vector", "std::vector");
+    add_cases<Kind::SEQUENCE, std::vector<K>, Key>(cases, "std::vector", "");
+    add_cases<Kind::SEQUENCE, My::List<K>, Key>(cases, "List", "std::list");
+    add_cases<Kind::SEQUENCE, std::list<K>, Key>(cases, "std::list", "");
+    add_cases<Kind::SEQUENCE, My::UnrolledList<K>, Key>(cases, "UnrolledList", "std::list");
+    add_cases<Kind::MAP, My::Map<K, std::uint64_t>, Key>(cases, "Map", "std::map");
+    add_cases<Kind::MAP, std::map<K, std::uint64_t>, Key>(cases, "std::map", "");
+    add_cases<Kind::MAP, My::HashMap<K, std::uint64_t>, Key>(cases, "HashMap", "std::unordered_map");
+    add_cases<Kind::MAP, std::unordered_map<K, std::uint64_t>, Key>(cases, "std::unordered_map", "");
+    add_cases<Kind::SET, My::Set<K>, Key>(cases, "Set", "std::set");
+    add_cases<Kind::SET, std::set<K>, Key>(cases, "std::set", "");
+    add_cases<Kind::SET, My::HashSet<K>, Key>(cases, "HashSet", "std::unordered_set");
+    add_cases<Kind::SET, std::unordered_set<K>, Key>(cases, "std::unordered_set", "");
+}
+
+// one pool per thread count, created when its first case runs
+My::parallel::ThreadPool& pool_for(std::size_t threads) {
+    static std::map<std::size_t, std::unique_ptr<My::parallel::ThreadPool>> pools;
+    auto& pool = pools[threads];
+    if (!pool) pool = std::make_unique<My::parallel::ThreadPool>(threads);
+    return *pool;
+}
+
+// My::parallel algorithms on a My::Vector of uint64 with 1 to 64 threads, the ratio column is the time relative to one thread
+void add_parallel_cases(std::vector<Bench::Case>& cases) {
+    using Algorithm = void (*)(My::parallel::ThreadPool&, My::Vector<std::uint64_t>&);
+    const std::pair<const char*, Algorithm> algorithms[] = {
+        { "sort", [](My::parallel::ThreadPool& pool, My::Vector<std::uint64_t>& v) { My::parallel::sort(pool, v.begin(), v.end()); } },
+        { "for_each", [](My::parallel::ThreadPool& pool, My::Vector<std::uint64_t>& v) { My::parallel::for_each(pool, v.begin(), v.end(), [](std::uint64_t& x) { x = x * 31 + 7; }); } },
+        { "transform", [](My::parallel::ThreadPool& pool, My::Vector<std::uint64_t>& v) { My::parallel::transform(pool, v.begin(), v.end(), v.begin(), [](std::uint64_t x) { return x ^ (x >> 17); }); } },
+        { "reduce", [](My::parallel::ThreadPool& pool, My::Vector<std::uint64_t>& v) { Bench::do_not_optimize(My::parallel::reduce(pool, v.begin(), v.end(), std::uint64_t(0))); } },
+        { "inclusive_scan", [](My::parallel::ThreadPool& pool, My::Vector<std::uint64_t>& v) { My::parallel::inclusive_scan(pool, v.begin(), v.end(), v.begin()); } },
+    };
+    for (auto& [operation, algorithm] : algorithms) {
+        for (std::size_t threads = 1; threads <= 64; threads *= 2) {
+            std::string container = "parallel/" + std::to_string(threads);
+            cases.push_back({ container + "/" + U64Key::name + "/" + operation, container, threads == 1 ? "" : "parallel/1", U64Key::name, operation,
+                [threads, algorithm = algorithm](Bench::State& state, std::size_t n) {
+                    My::Vector<std::uint64_t> v;
+                    v.reserve(static_cast<int>(n));
+                    for (auto key : keys_for<U64Key>(n, false)) v.push_back(key);
+                    My::parallel::ThreadPool& pool = pool_for(threads);
+                    state.start();
+                    algorithm(pool, v);
+                    state.stop();
+                    Bench::do_not_optimize(v);
+                } });
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    Bench::Options options;
+    try {
+        options = Bench::parse_options(argc, argv);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    std::vector<Bench::Case> cases;
+    add_key_type<IntKey>(cases);
+    add_key_type<U64Key>(cases);
+    add_key_type<ShortStringKey>(cases);
+    add_key_type<LongStringKey>(cases);
+    add_parallel_cases(cases);
+
+    return Bench::report(Bench::run_all(cases, options), options);
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+﻿#include <iostream>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <string>
+#include "My/ConcurrentHashMap.hpp"
+
+// the table before: one My::HashMap behind one global mutex
+template<typename T1, typename T2>
+class LockedHashMap {
+    mutable std::mutex mutex;
+    My::HashMap<T1, T2> map;
+public:
+    bool find(const T1& key, T2& value) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        const T2* found = map.find(key);
+        if (!found) return false;
+        value = *found;
+        return true;
+    }
+    bool insert_or_assign(const T1& key, const T2& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        bool inserted = !map.count(key);
+        map.insert(key, value);
+        return inserted;
+    }
+};
+
+// every thread looks up keys of a prefilled table, returns millions of lookups per second
+template<typename Table>
+double lookup_throughput(Table& table, int keys, int threads, long long lookups) {
+    std::atomic<long long> hits{ 0 };
+    std::vector<std::thread> workers;
+    long long per_thread = lookups / threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&table, &hits, keys, per_thread, t] {
+            long long local_hits = 0;
+            long long value;
+            unsigned key = t * 7919u;
+            for (long long i = 0; i < per_thread; i++) {
+                key = key * 1103515245u + 12345u;
+                if (table.find(static_cast<int>(key % (2u * keys)), value)) local_hits++;
+            }
+            hits.fetch_add(local_hits);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return per_thread * threads / seconds / 1e6;
+}
+
+int main() {
+    My::ConcurrentHashMap<std::string, int> stock(8);
+    stock.insert_or_assign("Apple", 150);
+    stock.insert_or_assign("Banana", 1000);
+    std::cout << "Banana assigned again, inserted: " << stock.insert_or_assign("Banana", 500) << "\n";
+    std::cout << "compute_if_absent(\"Carrot\"): " << stock.compute_if_absent("Carrot", [] { return 250; }) << "\n";
+    std::cout << "compute_if_absent(\"Apple\"): " << stock.compute_if_absent("Apple", [] { return -1; }) << "\n";
+    std::cout << "erase(\"Orange\"): " << stock.erase("Orange") << " erase(\"Apple\"): " << stock.erase("Apple") << "\n";
+
+    std::atomic<int> total{ 0 };
+    stock.for_each([&total](const std::string&, const int& value) { total += value; }, 4);
+    int banana = 0;
+    stock.find("Banana", banana);
+    std::cout << "size(): " << stock.size() << " total: " << total << " Banana: " << banana << "\n";
+
+    // read throughput against the global lock, half of the looked up keys are present
+    const int keys = 100000;
+    const long long lookups = 2000000;
+    My::ConcurrentHashMap<int, long long> sharded;
+    LockedHashMap<int, long long> locked;
+    for (int i = 0; i < keys; i++) {
+        sharded.insert_or_assign(i, i);
+        locked.insert_or_assign(i, i);
+    }
+    std::cout << "threads  ConcurrentHashMap Mlookups/s  LockedHashMap Mlookups/s  (hardware threads: " << std::thread::hardware_concurrency() << ")\n";
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        double sharded_rate = lookup_throughput(sharded, keys, threads, lookups);
+        double locked_rate = lookup_throughput(locked, keys, threads, lookups);
+        std::cout << threads << "  " << sharded_rate << "  " << locked_rate << "\n";
+    }
+
+    return 0;
+}
\ No newline at end of file
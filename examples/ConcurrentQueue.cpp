@@ -0,0 +1,90 @@
+﻿#include <iostream>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <string>
+#include "My/ConcurrentQueue.hpp"
+#include "My/List.hpp"
+
+// the queue the work pool used before: My::List with push_back/pop_front behind one mutex
+template<typename T>
+class LockedList {
+    std::mutex mutex;
+    My::List<T> list;
+public:
+    void push(const T& element) {
+        std::lock_guard<std::mutex> lock(mutex);
+        list.push_back(element);
+    }
+    bool try_pop(T& element) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (list.empty()) return false;
+        element = std::move(list.front());
+        list.pop_front();
+        return true;
+    }
+};
+
+// half of the threads push, the other half pop until every pushed value is consumed, returns millions of operations per second
+template<typename Queue>
+double throughput(int threads, long long operations) {
+    Queue queue;
+    int producers = threads > 1 ? threads / 2 : 1;
+    int consumers = threads > 1 ? threads - producers : 1;
+    long long per_producer = operations / producers;
+    long long total = per_producer * producers;
+
+    std::atomic<long long> consumed{ 0 };
+    std::atomic<long long> checksum{ 0 };
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int p = 0; p < producers; p++) {
+        workers.emplace_back([&queue, per_producer] {
+            for (long long i = 1; i <= per_producer; i++) queue.push(i);
+        });
+    }
+    for (int c = 0; c < consumers; c++) {
+        workers.emplace_back([&queue, &consumed, &checksum, total] {
+            long long value;
+            long long local_sum = 0;
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (queue.try_pop(value)) {
+                    local_sum += value;
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+                else std::this_thread::yield();
+            }
+            checksum.fetch_add(local_sum);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (checksum.load() != producers * (per_producer * (per_producer + 1) / 2)) std::cout << "checksum mismatch!\n";
+    return 2.0 * total / seconds / 1e6;
+}
+
+int main() {
+    My::ConcurrentQueue<std::string> messages;
+    messages.push("first");
+    messages.emplace(3, 'x');
+
+    std::string message;
+    while (messages.try_pop(message)) {
+        std::cout << message << " ";
+    }
+    std::cout << "\n";
+    std::cout << "messages.empty(): " << messages.empty() << "\n";
+
+    // throughput against the mutex-wrapped list, 2 * operations push/pop pairs per run
+    const long long operations = 200000;
+    std::cout << "threads  ConcurrentQueue Mops/s  LockedList Mops/s  (hardware threads: " << std::thread::hardware_concurrency() << ")\n";
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        double lock_free = throughput<My::ConcurrentQueue<long long>>(threads, operations);
+        double locked = throughput<LockedList<long long>>(threads, operations);
+        std::cout << threads << "  " << lock_free << "  " << locked << "\n";
+    }
+
+    return 0;
+}
\ No newline at end of file
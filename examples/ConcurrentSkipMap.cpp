@@ -0,0 +1,95 @@
+﻿#include <iostream>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <string>
+#include "My/ConcurrentSkipMap.hpp"
+#include "My/Map.hpp"
+
+// the ordered index before: My::Map behind one mutex
+template<typename T1, typename T2>
+class LockedMap {
+    std::mutex mutex;
+    My::Map<T1, T2> map;
+public:
+    bool find(const T1& key, T2& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!map.count(key)) return false;
+        value = map.at(key);
+        return true;
+    }
+    bool insert(const T1& key, const T2& value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        bool inserted = !map.count(key);
+        map.insert(key, value);
+        return inserted;
+    }
+};
+
+// every thread runs a mix of 90% lookups and 10% inserts on random keys, returns millions of operations per second
+template<typename Table>
+double mixed_throughput(int threads, int keys, long long operations) {
+    Table table;
+    for (int i = 0; i < keys; i += 2) table.insert(i, i);
+
+    std::vector<std::thread> workers;
+    long long per_thread = operations / threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&table, keys, per_thread, t] {
+            long long value;
+            unsigned key = t * 7919u + 1;
+            for (long long i = 0; i < per_thread; i++) {
+                key = key * 1103515245u + 12345u;
+                int k = static_cast<int>((key >> 8) % keys);
+                if (i % 10 == 0) table.insert(k, i);
+                else table.find(k, value);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return per_thread * threads / seconds / 1e6;
+}
+
+int main() {
+    My::ConcurrentSkipMap<int, std::string> m{ { 30, "thirty" }, { 10, "ten" }, { 20, "twenty" } };
+    m.insert(40, "forty");
+    m.insert(10, "TEN");
+    std::cout << "insert_if_absent(20): " << m.insert_if_absent(20, "x") << " at(25): \"" << m.at(25) << "\" erase(30): " << m.erase(30) << "\n";
+
+    for (auto& i : m) {
+        std::cout << i.first << " " << i.second << "\n";
+    }
+    std::cout << "m.size(): " << m.size() << " m.count(30): " << m.count(30) << " lower_bound(21): " << m.lower_bound(21)->first << "\n\n";
+
+    // writers erase and insert while a reader walks the map, the walk sees every key that stays present
+    My::ConcurrentSkipMap<int, int> shared;
+    for (int i = 0; i < 1000; i++) shared.insert(i, i);
+    std::thread writer([&shared] {
+        for (int round = 0; round < 100; round++) {
+            for (int i = 1; i < 1000; i += 2) shared.erase(i);
+            for (int i = 1; i < 1000; i += 2) shared.insert(i, i);
+        }
+    });
+    int even_seen = 0;
+    for (int round = 0; round < 100; round++) {
+        for (auto& i : shared) {
+            if (i.first % 2 == 0) even_seen++;
+        }
+    }
+    writer.join();
+    std::cout << "even keys seen in 100 walks: " << even_seen << " (expected 50000)\n\n";
+
+    const int keys = 100000;
+    const long long operations = 1000000;
+    std::cout << "threads  ConcurrentSkipMap Mops/s  LockedMap Mops/s  (hardware threads: " << std::thread::hardware_concurrency() << ")\n";
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        double lock_free = mixed_throughput<My::ConcurrentSkipMap<int, long long>>(threads, keys, operations);
+        double locked = mixed_throughput<LockedMap<int, long long>>(threads, keys, operations);
+        std::cout << threads << "  " << lock_free << "  " << locked << "\n";
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+﻿#include <iostream>
+#include "My/Deque.hpp"
+#include "TestHashAndAllocator.hpp"
+
+int main() {
+    My::Deque<int> d{ 3,4,5 };
+    d.push_front(2);
+    d.push_front(1);
+    d.push_back(6);
+
+    int& stable = d[2];
+    for (int i = 0; i < 1000; i++) {
+        d.push_front(-i);
+        d.push_back(i);
+    }
+    for (int i = 0; i < 1000; i++) {
+        d.pop_front();
+        d.pop_back();
+    }
+
+    for (auto& i : d) {
+        std::cout << i << " ";
+    }
+    std::cout << "\n";
+    std::cout << "reference after 4000 end operations: " << stable << " d.size(): " << d.size() << "\n";
+
+    // used as a queue the deque reuses its blocks instead of growing the map
+    My::Deque<int, Test::Allocator<int>> queue;
+    long long sum = 0;
+    for (int i = 0; i < 100000; i++) {
+        queue.push_back(i);
+        if (queue.size() > 100) {
+            sum += queue.front();
+            queue.pop_front();
+        }
+    }
+    std::sort(d.begin(), d.end(), [](int a, int b) { return a > b; });
+    std::cout << "queue.size(): " << queue.size() << " sum: " << sum << " sorted descending: " << d.front() << ".." << d.back() << "\n";
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+﻿#include "My/HashMap.hpp"
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <chrono>
+#include "TestHashAndAllocator.hpp"
+
+int main() {
+    std::cout << "My::HashMap<std::string, int> A\n";
+
+    My::HashMap <std::string, int> A(4);
+
+    A.insert({ "Apple", 150 });
+    A.insert("Banana", 1000);
+    A.insert("Orange", 110);
+    A.insert("Banana", 500);
+    A.insert(std::make_pair("Carrot", 250));
+    A.erase("Orange");
+    A["Potato"] = 450;
+
+    for (auto& i : A)
+    {
+        std::cout << i.first << " " << i.second << "\n";
+    }
+
+    std::cout << "A[\"Apple\"]: " << A["Apple"] << "\nA.bucket(\"Apple\"): " << A.bucket("Apple") << "\nA.size(): " << A.size() << "\nA.count(\"Orange\"): " << A.count("Orange") << "\n\n";;
+
+    std::cout << "B = A\n";
+
+    My::HashMap<std::string, int> B = A;
+
+    for (auto& i : B)
+    {
+        std::cout << i.first << " " << i.second << "\n";
+    }
+    std::cout << "\n";
+
+    std::cout << "initializer_list\n";
+
+    My::HashMap <std::string, std::string> C{ { "AAA", "aaa" }, { "BBB", "bbb" }, { "CCC", "ccc" } };
+
+    C["DDD"] = "ddd";
+
+    for (auto& i : C)
+    {
+        std::cout << i.first << " " << i.second << "\n";
+    }
+    std::cout << "\n";
+
+    std::cout << "custom hash function + custom allocator\n";
+    My::HashMap <int, int, Test::Hash<int>, Test::Allocator<std::pair<int, int>>> D;
+
+    D.insert(1, 100);
+    D.insert(2, 200);
+    D.erase(2);
+
+    D.display();
+    std::cout << "\n";
+
+    std::cout << "stats(): std::hash vs Test::Hash<std::string>, which hashes a string to its length\n";
+    My::HashMap<std::string, int> good;
+    My::HashMap<std::string, int, Test::Hash<std::string>> bad;
+    bad.set_rehash_hook([](const My::RehashEvent& e) {
+        std::cout << "rehash " << e.old_bucket_count << " -> " << e.new_bucket_count << " buckets, size " << e.size << ", tombstones dropped " << e.tombstones_dropped << "\n";
+    });
+    for (int i = 0; i < 200; i++) {
+        good.insert("key" + std::to_string(i), i);
+        bad.insert("key" + std::to_string(i), i);
+    }
+    for (int i = 0; i < 200; i += 4) {
+        good.erase("key" + std::to_string(i));
+        bad.erase("key" + std::to_string(i));
+    }
+    auto print_stats = [](const char* name, const My::HashStats& s) {
+        std::cout << name << ": load factor " << s.load_factor << ", tombstones " << s.tombstones << ", average probe length " << s.average_probe_length
+            << ", max probe length " << s.max_probe_length << ", longest cluster " << s.longest_cluster << "\nprobe histogram:";
+        for (std::size_t i = 0; i < s.probe_histogram.size() && i < 8; i++) std::cout << " " << s.probe_histogram[i];
+        if (s.probe_histogram.size() > 8) std::cout << " ...";
+        std::cout << "\n";
+    };
+    print_stats("std::hash", good.stats());
+    print_stats("Test::Hash", bad.stats());
+    std::cout << "\n";
+
+    std::cout << "save() and open_mapped()\n";
+    My::HashMap<int, double> squares;
+    for (int i = 0; i < 100000; i++) squares.insert(i, static_cast<double>(i) * i);
+    squares.erase(10);
+    const std::string path = "HashMap_example.snapshot";
+    squares.save(path);
+    {
+        auto mapped = My::HashMap<int, double>::open_mapped(path);
+        std::cout << "size " << mapped.size() << ", buckets " << mapped.bucket_count() << ", 300 -> " << *mapped.find(300) << ", 10 present: " << mapped.count(10) << "\n";
+        mapped.insert(10, -1); // changes the mapped copy only
+        std::cout << "reopened after an insert into the mapped table, 10 present: " << My::HashMap<int, double>::open_mapped(path).count(10) << "\n";
+    }
+    {
+        // a forged header whose array sizes wrap around in 64 bits: 2^62 buckets in a 128 byte file
+        std::ifstream saved(path, std::ios::binary);
+        char header[128] = {};
+        saved.read(header, 112); // the fixed fields of the header, the counts start at byte 56
+        saved.close();
+        const std::uint64_t buckets = std::uint64_t(1) << 62, end = sizeof(header);
+        std::memcpy(header + 56, &buckets, sizeof(buckets)); // number_of_buckets
+        std::memcpy(header + 88, &end, sizeof(end)); // table_offset
+        std::memcpy(header + 96, &end, sizeof(end)); // flag_offset
+        std::memcpy(header + 104, &end, sizeof(end)); // file_size
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(header, sizeof(header));
+        bool rejected = false;
+        try {
+            My::HashMap<int, double>::open_mapped(path);
+        }
+        catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        std::cout << "forged snapshot with " << buckets << " buckets rejected: " << rejected << "\n";
+        if (!rejected) return 1;
+    }
+    std::remove(path.c_str());
+    std::cout << "\n";
+
+    std::cout << "build_parallel() and rehash_parallel() with 4 threads\n";
+    std::vector<std::pair<int, int>> input;
+    for (int i = 0; i < 200000; i++) input.push_back({ (i * 7919) % 150000, i });
+    auto built = My::HashMap<int, int>::build_parallel(input.begin(), input.end(), 4);
+    My::HashMap<int, int> inserted;
+    for (const auto& element : input) inserted.insert(element.first, element.second);
+    bool same = built.size() == inserted.size();
+    for (const auto& element : inserted) same = same && built.find(element.first) && *built.find(element.first) == element.second;
+    std::cout << "size " << built.size() << ", buckets " << built.bucket_count() << ", same as insert(): " << same << "\n";
+    built.rehash_parallel(4);
+    same = built.size() == inserted.size();
+    for (const auto& element : inserted) same = same && built.find(element.first) && *built.find(element.first) == element.second;
+    std::cout << "after rehash_parallel() buckets " << built.bucket_count() << ", same as insert(): " << same << "\n";
+    std::cout << "\n";
+
+    std::cout << "set_rehash_step(): the slowest of 1000000 inserts\n";
+    for (std::size_t step : { 0, 64 }) {
+        My::HashMap<int, int> latency;
+        latency.set_rehash_step(step);
+        std::chrono::steady_clock::duration slowest{};
+        for (int i = 0; i < 1000000; i++) {
+            auto start = std::chrono::steady_clock::now();
+            latency.insert(i, i);
+            slowest = std::max(slowest, std::chrono::steady_clock::now() - start);
+        }
+        latency.finish_rehash();
+        bool complete = latency.size() == 1000000;
+        for (int i = 0; i < 1000000; i += 1000) complete = complete && *latency.find(i) == i;
+        std::cout << "step " << step << ": " << std::chrono::duration_cast<std::chrono::microseconds>(slowest).count() << " us, all found: " << complete << "\n";
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+﻿#include <string>
+#include "My/HashSet.hpp"
+#include "TestHashAndAllocator.hpp"
+
+int main() {
+    using namespace My;
+
+    std::cout << "My::HashSet\n";
+
+    HashSet<int> A;
+    A.insert(1);
+    A.erase(1);
+    A.insert(2);
+    A.erase(2);
+    A.insert(3);
+    A.insert(4);
+    A.insert(5);
+ 
+    for (auto& i : A)
+    {
+        std::cout << i << " ";
+    }
+    std::cout << "\n";
+
+    std::cout << "A.size(): " << A.size() << "\nA.bucket_count(): " << A.bucket_count() << "\n";
+
+    HashSet<int> B = A;
+
+    A = B;
+
+    for (HashSet<int>::iterator it = B.begin(); it != B.end(); it++)
+    {
+        std::cout << *it << " ";
+    }
+    std::cout << "\n";
+
+    B.insert(9);
+    B.insert(53);
+    B.insert(979);
+    B.insert(32);
+
+    A = std::move(B);
+
+    for (auto& i : A)
+    {
+        std::cout << i << " ";
+    }
+    std::cout << "\n";
+
+    A.clear();
+    std::cout << A.empty() << "\n\n";
+
+    std::cout << "initializer_list\n";
+
+    HashSet<std::string> E{"Apple", "Banana", "Cucumber", "Frog", "Set", "31314", " ", "ABCDE"};
+    E.erase("31314");
+
+    for (auto& i : E)
+    {
+        std::cout << i << " ";
+    }
+    std::cout << "\n";
+
+    std::cout << E.size() << "\n\n";
+
+    std::cout << "custom hash function + custom allocator\n";
+
+    HashSet <int, Test::Hash<int>, Test::Allocator<int>> G;
+
+    G.insert(1);
+    G.insert(20);
+    G.erase(20);
+
+    G.display();
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+﻿#include <iostream>
+#include <string>
+#include <vector>
+#include "My/Intrusive.hpp"
+
+// one object in three containers at once: an LRU list, an expiry index and an index by id
+struct Session {
+    Session(int _id, long long _expires_at, std::string _user) : id(_id), expires_at(_expires_at), user(std::move(_user)) {}
+
+    int id;
+    long long expires_at;
+    std::string user;
+
+    My::ListHook lru_hook;
+    My::MapHook expiry_hook;
+    My::MapHook id_hook;
+};
+
+int main() {
+    std::vector<Session> sessions;
+    sessions.reserve(5); // elements must not move while they are linked
+    sessions.emplace_back(1, 500, "alice");
+    sessions.emplace_back(2, 300, "bob");
+    sessions.emplace_back(3, 900, "carol");
+    sessions.emplace_back(4, 100, "dave");
+    sessions.emplace_back(5, 700, "erin");
+
+    My::IntrusiveList<Session, &Session::lru_hook> lru;
+    My::IntrusiveMap<long long, Session, &Session::expiry_hook, &Session::expires_at> by_expiry;
+    My::IntrusiveMap<int, Session, &Session::id_hook, &Session::id> by_id;
+
+    for (auto& s : sessions) {
+        lru.push_front(s);
+        by_expiry.insert(s);
+        by_id.insert(s);
+    }
+
+    // a request for session 2 moves it to the front of the LRU list without any allocation
+    Session& touched = *by_id.find(2);
+    lru.splice(lru.begin(), touched);
+
+    std::cout << "lru: ";
+    for (auto& s : lru) {
+        std::cout << s.user << " ";
+    }
+    std::cout << "\n";
+
+    // expire everything up to time 400, every unlink is O(1) in the list and O(log n) in the maps
+    while (!by_expiry.empty() && by_expiry.begin()->expires_at <= 400) {
+        Session& expired = *by_expiry.begin();
+        by_expiry.erase(expired);
+        by_id.erase(expired);
+        lru.erase(expired);
+        std::cout << "expired " << expired.user << "\n";
+    }
+
+    std::cout << "by expiry: ";
+    for (auto& s : by_expiry) {
+        std::cout << s.user << "(" << s.expires_at << ") ";
+    }
+    std::cout << "\n";
+
+    std::cout << "lru.size(): " << lru.size() << " by_id.size(): " << by_id.size() << " session 4 linked: " << sessions[3].lru_hook.is_linked() << "\n";
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+﻿#include "My/List.hpp"
+#include "TestHashAndAllocator.hpp"
+#include <string>
+
+int main() {
+	My::List<int> a{ 1,2,3,4,5,6,7 };
+
+	a.insert(a.begin(), 5, 10);
+	a.erase(a.begin(), ++++a.begin());
+
+	for (auto& i : a) {
+		std::cout << i << " ";
+	}
+	std::cout << "\n";
+
+	My::List<int> b = a;
+
+	b.pop_back();
+	b.pop_front();
+	b.push_back(1000);
+	b.push_front(0);
+
+	for (auto& i : b) {
+		std::cout << i << " ";
+	}
+	std::cout << "\n";
+
+	std::cout << "a.size(): " << a.size() << " b.size(): " << b.size() << "\n";
+
+	// LRU order: a touched key moves to the front without allocating or copying
+	My::List<int, Test::Allocator<int>> lru{ 1,2,3,4,5 };
+	auto touched = ++++lru.begin();
+	lru.splice(lru.begin(), lru, touched);
+
+	My::List<int, Test::Allocator<int>> pending{ 9,7,8 };
+	pending.sort();
+	lru.sort();
+	lru.merge(pending);
+
+	for (auto& i : lru) {
+		std::cout << i << " ";
+	}
+	std::cout << "\n";
+
+	std::cout << "lru.size(): " << lru.size() << " pending.size(): " << pending.size() << "\n";
+
+	// message buffers are built inside the nodes and moved between lists, never copied
+	My::List<std::string> outbox;
+	outbox.emplace_back(4096, 'a');
+	outbox.emplace_front("header");
+	std::string body(1024, 'b');
+	outbox.insert(++outbox.begin(), std::move(body));
+
+	My::List<std::string> sent;
+	sent.push_back(std::move(outbox.back()));
+	outbox.pop_back();
+
+	std::cout << "outbox.size(): " << outbox.size() << " front: " << outbox.front() << " sent.front().size(): " << sent.front().size() << "\n";
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+﻿#include <iostream>
+#include <string>
+#include <sstream>
+#include "My/Map.hpp"
+
+// stateful three-way comparator: orders strings by a collation table instead of raw char codes
+struct CollationCompare {
+    int weight[256];
+
+    CollationCompare() {
+        for (int i = 0; i < 256; i++) weight[i] = (i >= 'a' && i <= 'z') ? i - 'a' + 'A' : i;
+    }
+    std::weak_ordering operator()(const std::string& lhs, const std::string& rhs) const {
+        std::size_t n = std::min(lhs.size(), rhs.size());
+        for (std::size_t i = 0; i < n; i++) {
+            int a = weight[static_cast<unsigned char>(lhs[i])], b = weight[static_cast<unsigned char>(rhs[i])];
+            if (a != b) return a <=> b;
+        }
+        return lhs.size() <=> rhs.size();
+    }
+};
+
+// a key with only operator<, the default comparator falls back to it
+struct Version {
+    int major, minor;
+    bool operator<(const Version& other) const { return major != other.major ? major < other.major : minor < other.minor; }
+};
+
+int main() {
+    My::Map<int, int> m{ {200,7}, {150,5}, {250,9}, {120,4}, {160,6}, {230,8}, {280,11}, {270,10}, {90,1}, {110, 3}, {100,2} };
+
+    for (auto& i : m) {
+        std::cout << i.first << " " << i.second << "\n";
+    }
+    std::cout << "\n";
+
+    std::cout << "m.size(): " << m.size() << "\n";
+    std::cout << "m[150]: " << m[150] << "\n\n";
+
+    m[300] = 12;
+
+    for (auto& i : m) {
+        std::cout << i.first << " " << i.second << "\n";
+    }
+    std::cout << "\n";
+
+    std::vector<std::pair<int, int>> snapshot{ {1,10}, {2,20}, {3,30}, {4,40}, {5,50} };
+    My::Map<int, int> n = My::Map<int, int>::from_sorted(snapshot.begin(), snapshot.end());
+
+    for (auto& i : n) {
+        std::cout << i.first << " " << i.second << "\n";
+    }
+    std::cout << "\n";
+
+    My::Map<std::string, int, CollationCompare> words{ {"banana", 1}, {"Apple", 2}, {"cherry", 3}, {"APPLE", 4} };
+    for (auto& i : words) {
+        std::cout << i.first << " " << i.second << "\n";
+    }
+    std::cout << "\n";
+
+    My::Map<Version, std::string> releases{ {{2, 1}, "b"}, {{1, 9}, "a"}, {{2, 0}, "c"} };
+    releases.insert({ 1, 9 }, "a2");
+    for (auto& i : releases) {
+        std::cout << i.first.major << "." << i.first.minor << " " << i.second << "\n";
+    }
+    std::cout << "\n";
+
+    // the keys are written as differences to the previous key, a sorted run of close keys takes a byte or two per entry
+    My::Map<int, int> index;
+    for (int i = 0; i < 10000; i++) index.insert(i * 4, i);
+    std::stringstream checkpoint;
+    index.write_to(checkpoint);
+    My::Map<int, int> restored;
+    restored.read_from(checkpoint);
+    std::cout << "write_to(): " << checkpoint.str().size() << " bytes for " << index.size() << " entries, read_from(): size " << restored.size() << ", restored[400]: " << restored[400] << "\n";
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+﻿#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include "My/MappedVector.hpp"
+
+struct Trade {
+    std::uint64_t id;
+    double price;
+    std::uint32_t quantity;
+};
+
+int main() {
+    const std::string path = "MappedVector_example.bin";
+    std::remove(path.c_str());
+
+    {
+        // appending is sequential, so the kernel may read ahead and drop pages behind us
+        My::MappedVector<Trade> trades(path, My::Access::SEQUENTIAL);
+        for (std::uint64_t i = 0; i < 1000000; i++) {
+            trades.push_back({ i, 100.0 + static_cast<double>(i % 50), static_cast<std::uint32_t>(i % 7 + 1) });
+        }
+        trades.flush();
+        std::cout << "trades.size(): " << trades.size() << ", trades.capacity(): " << trades.capacity() << "\n";
+
+        double volume = 0;
+        for (auto& trade : trades) volume += trade.price * trade.quantity;
+        std::cout << "volume: " << volume << "\n";
+    }
+
+    {
+        // the data is still in the file, reopening it maps the same records without reading them
+        My::MappedVector<Trade> trades(path, My::Access::RANDOM);
+        std::cout << "reopened, size: " << trades.size() << ", trades[123456].price: " << trades[123456].price << "\n";
+
+        trades.resize(10);
+        trades.push_back({ 42, 1.5, 3 });
+        trades.shrink_to_fit();
+        for (auto& trade : trades) std::cout << trade.id << " ";
+        std::cout << "\n";
+    }
+
+    std::remove(path.c_str());
+    return 0;
+}
\ No newline at end of file
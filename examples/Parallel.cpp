@@ -0,0 +1,50 @@
+﻿#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "My/Vector.hpp"
+#include "My/Parallel.hpp"
+
+// fills v with n pseudo-random numbers
+void fill(My::Vector<std::uint64_t>& v, int n) {
+    v.clear();
+    v.reserve(n);
+    std::uint64_t x = 88172645463325252ull;
+    for (int i = 0; i < n; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        v.push_back(x % 1000000);
+    }
+}
+
+int main() {
+    const int n = 2000000;
+    My::Vector<std::uint64_t> v;
+
+    std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t threads : { std::size_t(1), std::size_t(2), hardware }) {
+        My::parallel::ThreadPool pool(threads);
+        fill(v, n);
+
+        auto start = std::chrono::steady_clock::now();
+        My::parallel::sort(pool, v.begin(), v.end());
+        My::parallel::transform(pool, v.begin(), v.end(), v.begin(), [](std::uint64_t x) { return x % 10; });
+        std::uint64_t sum = My::parallel::reduce(pool, v.begin(), v.end(), std::uint64_t(0));
+        My::parallel::inclusive_scan(pool, v.begin(), v.end(), v.begin());
+        bool scan_matches = v.back() == sum;
+        std::uint64_t odd = 0;
+        My::parallel::for_each(pool, v.begin(), v.end(), [](std::uint64_t& x) { x &= 1; });
+        for (auto x : v) odd += x;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << threads << " thread(s): sum " << sum << ", last prefix sum matches: " << scan_matches << ", odd prefixes " << odd << ", " << ms << " ms\n";
+    }
+
+    fill(v, n);
+    My::parallel::sort(v.begin(), v.end(), [](std::uint64_t a, std::uint64_t b) { return a > b; }); // on ThreadPool::global()
+    std::cout << "sorted descending: " << std::is_sorted(v.begin(), v.end(), [](std::uint64_t a, std::uint64_t b) { return a > b; }) << "\n";
+
+    return 0;
+}
\ No newline at end of file
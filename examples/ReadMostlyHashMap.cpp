@@ -0,0 +1,117 @@
+﻿#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <chrono>
+#include <algorithm>
+#include "My/ReadMostlyHashMap.hpp"
+#include "My/HashMap.hpp"
+
+// the table before: My::HashMap behind a reader/writer lock
+template<typename T1, typename T2>
+class SharedLockedHashMap {
+    mutable std::shared_mutex mutex;
+    My::HashMap<T1, T2> map;
+public:
+    bool find(const T1& key, T2& value) const {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        const T2* found = map.find(key);
+        if (!found) return false;
+        value = *found;
+        return true;
+    }
+    void insert(const T1& key, const T2& value) {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        map.insert(key, value);
+    }
+};
+
+struct ReadResult {
+    double lookups_per_second; // millions
+    double worst_lookup_us;
+};
+
+// readers look up keys while one writer keeps updating values and inserting new keys
+template<typename Table>
+ReadResult read_under_writes(int readers, int keys, long long lookups) {
+    Table table;
+    for (int i = 0; i < keys; i++) table.insert(i, i);
+
+    std::atomic<bool> done{ false };
+    std::thread writer([&table, &done, keys] {
+        for (int i = 0; !done.load(std::memory_order_relaxed); i++) {
+            table.insert(i % keys, i); // every keys-th round also grows the table
+            if (i % 64 == 0) table.insert(keys + i, i);
+            std::this_thread::yield(); // a steady stream of updates, not a writer that owns a core
+        }
+    });
+
+    std::atomic<long long> worst_ns{ 0 };
+    std::vector<std::thread> workers;
+    long long per_reader = lookups / readers;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < readers; r++) {
+        workers.emplace_back([&table, &worst_ns, keys, per_reader, r] {
+            long long value;
+            long long local_worst = 0;
+            unsigned key = r * 7919u;
+            for (long long i = 0; i < per_reader; i++) {
+                key = key * 1103515245u + 12345u;
+                auto begin = std::chrono::steady_clock::now();
+                table.find(static_cast<int>(key % keys), value);
+                long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+                local_worst = std::max(local_worst, ns);
+            }
+            long long current = worst_ns.load();
+            while (local_worst > current && !worst_ns.compare_exchange_weak(current, local_worst));
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    done.store(true);
+    writer.join();
+    return { per_reader * readers / seconds / 1e6, worst_ns.load() / 1000.0 };
+}
+
+int main() {
+    My::ReadMostlyHashMap<std::string, int> prices;
+    prices.insert({ "Apple", 150 });
+    prices.insert("Banana", 1000);
+    prices.insert("Orange", 110);
+    prices.insert("Banana", 500);
+    prices.erase("Orange");
+
+    // a reader thread never blocks, even while the writer replaces values
+    std::thread reader([&prices] {
+        int value = 0;
+        for (int i = 0; i < 1000; i++) prices.find("Banana", value);
+        std::cout << "reader saw Banana: " << value << "\n";
+    });
+    for (int i = 0; i < 1000; i++) prices.insert("Banana", 500 + i % 2);
+    reader.join();
+
+    prices.for_each([](const std::string& key, const int& value) { std::cout << key << " " << value << "\n"; });
+    std::cout << "prices.size(): " << prices.size() << " prices.count(\"Orange\"): " << prices.count("Orange") << "\n";
+
+    My::ReadMostlyHashSet<int> seen;
+    for (int i = 0; i < 20; i += 3) seen.insert(i);
+    seen.erase(9);
+    std::cout << "seen: ";
+    seen.for_each([](const int& key) { std::cout << key << " "; });
+    std::cout << "\n\n";
+
+    const int keys = 100000;
+    const long long lookups = 2000000;
+    std::cout << "readers  ReadMostlyHashMap Mlookups/s (worst us)  SharedLockedHashMap Mlookups/s (worst us)  (hardware threads: " << std::thread::hardware_concurrency() << ")\n";
+    for (int readers = 1; readers <= 16; readers *= 2) {
+        ReadResult lock_free = read_under_writes<My::ReadMostlyHashMap<int, long long>>(readers, keys, lookups);
+        ReadResult locked = read_under_writes<SharedLockedHashMap<int, long long>>(readers, keys, lookups);
+        std::cout << readers << "  " << lock_free.lookups_per_second << " (" << lock_free.worst_lookup_us << ")  "
+            << locked.lookups_per_second << " (" << locked.worst_lookup_us << ")\n";
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+﻿#include <iostream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <string>
+#include "My/RingBuffer.hpp"
+
+// moves messages from producers to consumers through the ring, returns millions of messages per second
+template<My::RingMode Mode>
+double ring_throughput(int producers, int consumers, long long messages, std::size_t batch) {
+    My::RingBuffer<long long, Mode> ring(1024);
+    long long per_producer = messages / producers;
+    long long total = per_producer * producers;
+    std::atomic<long long> consumed{ 0 };
+    std::atomic<long long> checksum{ 0 };
+
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int p = 0; p < producers; p++) {
+        workers.emplace_back([&ring, per_producer, batch] {
+            std::vector<long long> values(batch);
+            for (long long next = 1; next <= per_producer;) {
+                std::size_t count = static_cast<std::size_t>(std::min<long long>(batch, per_producer - next + 1));
+                for (std::size_t i = 0; i < count; i++) values[i] = next + i;
+                std::size_t pushed = batch == 1 ? ring.try_push(values[0]) : ring.push_n(values.begin(), count);
+                if (pushed == 0) std::this_thread::yield();
+                next += pushed;
+            }
+        });
+    }
+    for (int c = 0; c < consumers; c++) {
+        workers.emplace_back([&ring, &consumed, &checksum, total, batch] {
+            std::vector<long long> values(batch);
+            long long local_sum = 0;
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                std::size_t popped = batch == 1 ? ring.try_pop(values[0]) : ring.pop_n(values.begin(), batch);
+                if (popped == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (std::size_t i = 0; i < popped; i++) local_sum += values[i];
+                consumed.fetch_add(popped, std::memory_order_relaxed);
+            }
+            checksum.fetch_add(local_sum);
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (checksum.load() != producers * (per_producer * (per_producer + 1) / 2)) std::cout << "checksum mismatch!\n";
+    return total / seconds / 1e6;
+}
+
+int main() {
+    My::RingBuffer<std::string> ring(5);
+    std::cout << "capacity: " << ring.capacity() << "\n";
+    for (int i = 0; i < 10; i++) {
+        if (!ring.try_emplace(i + 1, 'a' + i)) {
+            std::cout << "full after " << i << " pushes\n";
+            break;
+        }
+    }
+
+    std::string batch[3];
+    std::size_t popped = ring.pop_n(batch, 3);
+    for (std::size_t i = 0; i < popped; i++) {
+        std::cout << batch[i] << " ";
+    }
+    std::cout << "\n";
+    std::cout << "ring.size(): " << ring.size() << "\n";
+
+    const long long messages = 1 << 21;
+    std::cout << "SPSC single: " << ring_throughput<My::RingMode::SPSC>(1, 1, messages, 1) << " Mmsg/s\n";
+    std::cout << "SPSC batch of 64: " << ring_throughput<My::RingMode::SPSC>(1, 1, messages, 64) << " Mmsg/s\n";
+    std::cout << "MPMC 2x2 single: " << ring_throughput<My::RingMode::MPMC>(2, 2, messages, 1) << " Mmsg/s\n";
+    std::cout << "MPMC 2x2 batch of 64: " << ring_throughput<My::RingMode::MPMC>(2, 2, messages, 64) << " Mmsg/s\n";
+
+    return 0;
+}
\ No newline at end of file
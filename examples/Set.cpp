@@ -0,0 +1,50 @@
+﻿#include <iostream>
+#include "My/Set.hpp"
+
+int main() {
+    My::Set<int> s{ 1,2,3,4,5,6,6,3,1,1 };
+    s.insert(11);
+
+    for (auto& i : s)
+    {
+        std::cout << i << " ";
+    }
+    std::cout << "\n";
+    
+    My::Set<int> t = s;
+    for (auto& i : t)
+    {
+        std::cout << i << " ";
+    }
+    std::cout << "\n";
+
+    t.clear();
+
+    std::vector<int> unsorted{ 9,4,7,1,4,8 };
+    My::Set<int> u = My::Set<int>::from_unsorted(unsorted.begin(), unsorted.end());
+    for (auto& i : u)
+    {
+        std::cout << i << " ";
+    }
+    std::cout << "\n";
+
+    std::cout << "s.size(): " << s.size() << " t.size(): " << t.size() << "\n";
+
+    My::Set<int, std::compare_three_way, true> latencies{ 12,7,30,18,3,25,9,41,15,22 };
+    std::cout << "p50: " << *latencies.nth(latencies.size() / 2) << " p90: " << *latencies.nth(latencies.size() * 9 / 10) << "\n";
+    std::cout << "latencies below 20: " << latencies.rank(20) << "\n";
+
+    My::Set<int> evens{ 0,2,4,6,8,10,12 };
+    My::Set<int> high = evens.split(6); // evens: 0 2 4, high: 6 8 10 12
+    My::Set<int> odds{ 1,3,5 };
+    evens.set_union(std::move(odds));
+    evens.set_difference(My::Set<int>{ 1,2,3 });
+    evens.join(high); // every key of high is greater than every key of evens
+    for (auto& i : evens)
+    {
+        std::cout << i << " ";
+    }
+    std::cout << "\n";
+
+    return 0;
+}
\ No newline at end of file
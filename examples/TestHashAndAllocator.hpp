@@ -8,7 +8,7 @@ namespace Test {
     template<class T> // custom hash function
     class Hash {
     public:
-        std::size_t operator()(T key) {
+        std::size_t operator()(T key) const {
             return abs(static_cast<int>(key));
         }
     };
@@ -16,7 +16,7 @@ namespace Test {
     template<>
     class Hash<std::string> {
     public:
-        std::size_t operator()(std::string key) {
+        std::size_t operator()(std::string key) const {
             return key.size();
         }
     };
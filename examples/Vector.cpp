@@ -0,0 +1,61 @@
+﻿#include "My/Vector.hpp"
+#include "TestHashAndAllocator.hpp"
+
+int main() {
+    // using namespace My;
+    My::Vector<int> a{ 0,1,2,3,4,5,6,7,8,9 };
+    My::Vector<int, Test::Allocator<int>> with_alloc;
+
+    a.push_back(10);
+    a.push_back(11);
+    a.pop_back();
+
+    a.insert(a.end(), 5, 55);
+
+    for (auto& i : a) {
+         std::cout << i << " ";
+    }
+    std::cout << "\n";
+
+    a.erase(a.begin() + 5, a.end() - 5);
+
+    for (auto& i : a) {
+        std::cout << i << " ";
+    }
+    std::cout << "\n";
+
+    std::cout << "size: " << a.size() << " capacity: " << a.capacity() << std::endl;
+
+    a.resize(7);
+    for (auto& i : a) {
+       std::cout << i << " ";
+    }
+    std::cout << "\n";
+
+    std::cout << "size: " << a.size() << " capacity: " << a.capacity() << std::endl;
+
+    std::cout << a.empty() << std::endl;
+    a.clear();
+    std::cout << a.empty() << std::endl;
+
+    a.insert(a.begin(), { 10,11,12 });
+    a[2] *= 2;
+
+    std::cout << a[0] << " " << a[1] << " " << a[2] << "\n";
+
+    My::Vector<int> b = std::move(a);
+    My::Vector<int> c(5, 10);
+    b = c;
+
+    for (auto& i : b) {
+        std::cout << i << " ";
+    }
+    std::cout << "\n";
+
+    My::Vector<std::string> d(3, "ABCDE");
+    d.push_back("FGHIJ");
+    d.pop_back();
+    d.erase(d.begin(), d.end());
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+﻿#pragma once
+#ifndef __COMPARE_HPP__
+#define __COMPARE_HPP__
+
+#include <compare>
+#include <concepts>
+
+namespace My {
+    // the default Compare of My::Map, My::Set and My::ConcurrentSkipMap: operator<=> for keys that have it,
+    // so every visited node costs one call, otherwise operator< like std::less, which the containers call twice
+    // where they need to tell equal keys apart
+    struct DefaultCompare {
+        template <typename L, typename R>
+        constexpr auto operator()(const L& lhs, const R& rhs) const {
+            if constexpr (std::three_way_comparable_with<L, R>) return lhs <=> rhs;
+            else return static_cast<bool>(lhs < rhs);
+        }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,181 @@
+﻿#pragma once
+#ifndef __CONCURRENT_HASHMAP_HPP__
+#define __CONCURRENT_HASHMAP_HPP__
+
+#include <utility>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include <exception>
+#include <cstdint>
+#include "HashMap.hpp"
+
+namespace My {
+    // hash map for many threads: keys are spread over independently locked HashMap shards,
+    // lookups take the shard lock in shared mode, so readers of one shard do not wait for each other
+    template <typename T1, typename T2, typename Hash = std::hash<T1>, typename Allocator = std::allocator<std::pair<T1, T2>>>
+    class ConcurrentHashMap {
+        struct alignas(64) Shard { // one shard per cache line, so locking one shard does not bounce its neighbours
+            mutable std::shared_mutex mutex;
+            HashMap<T1, T2, Hash, Allocator> map;
+        };
+
+        std::unique_ptr<Shard[]> shards;
+        std::size_t shard_count; // power of two
+        unsigned shard_bits;
+        Hash hash;
+
+        Shard& shard_of(const T1& key) const {
+            // the shards use the low bits of the hash for their buckets, so the shard is taken from the high bits of a mixed hash
+            if (!shard_bits) return shards[0];
+            std::uint64_t mixed = static_cast<std::uint64_t>(hash(key)) * 0x9E3779B97F4A7C15ull;
+            return shards[static_cast<std::size_t>(mixed >> (64 - shard_bits))];
+        }
+
+    public:
+        ConcurrentHashMap(std::size_t _shard_count = 64, const Hash& _hash = Hash(), const Allocator& _alloc = Allocator());
+        ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+        ConcurrentHashMap& operator= (const ConcurrentHashMap&) = delete;
+
+        bool find(const T1& key, T2& value) const; // copies the value out under the shard lock, false if the key is absent
+        bool count(const T1& key) const;
+        bool insert_or_assign(const T1& key, const T2& value); // true if the key was inserted, false if it was assigned
+        bool erase(const T1& key); // false if the key was absent
+        // returns the value of the key, factory() is called at most once and only if the key is absent
+        template<typename Factory>
+        T2 compute_if_absent(const T1& key, Factory factory);
+        // calls f(key, value) for every element, the shards are split between threads and each one is read under its shared lock,
+        // f must be safe to call from several threads at once and must not modify this map; the first exception of f is rethrown
+        // after every thread has stopped
+        template<typename Function>
+        void for_each(Function f, unsigned threads = std::thread::hardware_concurrency()) const;
+        std::size_t size() const; // only a snapshot while other threads insert or erase
+        bool empty() const { return size() == 0; }
+        std::size_t shards_count() const noexcept { return shard_count; }
+    };
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    ConcurrentHashMap<T1, T2, Hash, Allocator>::ConcurrentHashMap(std::size_t _shard_count, const Hash& _hash, const Allocator& _alloc) : hash(_hash) {
+        if (_shard_count == 0 || _shard_count > (std::size_t(1) << 16)) throw std::length_error("shard count must be in [1, 65536]."); // EXCEPTION
+        shard_count = 1;
+        shard_bits = 0;
+        while (shard_count < _shard_count) {
+            shard_count <<= 1;
+            shard_bits++;
+        }
+
+        shards = std::make_unique<Shard[]>(shard_count);
+        for (std::size_t i = 0; i < shard_count; i++) {
+            shards[i].map = HashMap<T1, T2, Hash, Allocator>(_hash, _alloc);
+        }
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    bool ConcurrentHashMap<T1, T2, Hash, Allocator>::find(const T1& key, T2& value) const {
+        Shard& shard = shard_of(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        // the const find(), the other one may advance an incremental rehash, which only the unique lock allows
+        const T2* found = std::as_const(shard.map).find(key);
+        if (!found) return false;
+        value = *found;
+        return true;
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    bool ConcurrentHashMap<T1, T2, Hash, Allocator>::count(const T1& key) const {
+        Shard& shard = shard_of(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        return shard.map.count(key);
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    bool ConcurrentHashMap<T1, T2, Hash, Allocator>::insert_or_assign(const T1& key, const T2& value) {
+        Shard& shard = shard_of(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        if (T2* found = shard.map.find(key)) {
+            *found = value;
+            return false;
+        }
+        shard.map.insert(key, value);
+        return true;
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    bool ConcurrentHashMap<T1, T2, Hash, Allocator>::erase(const T1& key) {
+        Shard& shard = shard_of(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        if (!shard.map.count(key)) return false;
+        shard.map.erase(key);
+        return true;
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    template<typename Factory>
+    T2 ConcurrentHashMap<T1, T2, Hash, Allocator>::compute_if_absent(const T1& key, Factory factory) {
+        Shard& shard = shard_of(key);
+        {
+            // most calls find the key, they only need the shared lock
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            if (const T2* found = std::as_const(shard.map).find(key)) return *found;
+        }
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        if (const T2* found = std::as_const(shard.map).find(key)) return *found; // another thread inserted it between the two locks
+        T2 value = factory();
+        shard.map.insert(key, value);
+        return value;
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    template<typename Function>
+    void ConcurrentHashMap<T1, T2, Hash, Allocator>::for_each(Function f, unsigned threads) const {
+        auto visit = [this, &f](std::size_t i) {
+            std::shared_lock<std::shared_mutex> lock(shards[i].mutex);
+            shards[i].map.for_each(f);
+        };
+        if (threads <= 1 || shard_count == 1) {
+            for (std::size_t i = 0; i < shard_count; i++) visit(i);
+            return;
+        }
+
+        // shards differ in size, so every worker takes the next unvisited shard instead of a fixed range
+        std::atomic<std::size_t> next{ 0 };
+        // like HashMap::run_threads(): the first exception of f is kept, every thread is joined and then it is rethrown
+        std::mutex error_lock;
+        std::exception_ptr error;
+        auto work = [this, &next, &visit, &error_lock, &error] {
+            try {
+                for (std::size_t i = next.fetch_add(1); i < shard_count; i = next.fetch_add(1)) visit(i);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> guard(error_lock);
+                if (!error) error = std::current_exception();
+            }
+        };
+        std::vector<std::thread> workers;
+        try {
+            for (unsigned t = 1; t < threads && t < shard_count; t++) workers.emplace_back(work);
+        }
+        catch (...) {
+            for (auto& worker : workers) worker.join();
+            throw;
+        }
+        work();
+        for (auto& worker : workers) worker.join();
+        if (error) std::rethrow_exception(error);
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    std::size_t ConcurrentHashMap<T1, T2, Hash, Allocator>::size() const {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < shard_count; i++) {
+            std::shared_lock<std::shared_mutex> lock(shards[i].mutex);
+            total += shards[i].map.size();
+        }
+        return total;
+    }
+}
+
+#endif // !__CONCURRENT_HASHMAP_HPP__
\ No newline at end of file
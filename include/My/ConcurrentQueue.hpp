@@ -0,0 +1,145 @@
+﻿#pragma once
+#ifndef __CONCURRENT_QUEUE_HPP__
+#define __CONCURRENT_QUEUE_HPP__
+
+#include <utility>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include "Reclamation.hpp"
+
+namespace My {
+    // unbounded lock-free multi-producer multi-consumer queue (Michael-Scott) with hazard pointer reclamation,
+    // nodes come from a per-thread cached pool, so a steady stream of push/pop does not call the allocator
+    template <typename T>
+    class ConcurrentQueue {
+        static_assert(std::is_nothrow_move_assignable_v<T>, "try_pop() moves the value out after it has taken the node, the move must not throw");
+
+        struct Node {
+            std::atomic<Node*> next{ nullptr };
+            alignas(T) unsigned char storage[sizeof(T)]; // empty in the dummy head node
+            T* value() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+        };
+        using Pool = ConcurrentNodePool<sizeof(Node), alignof(Node)>;
+
+        alignas(64) std::atomic<Node*> head; // dummy node, the first value is in head->next
+        alignas(64) std::atomic<Node*> tail;
+
+        static Node* create_node() { return ::new (Pool::allocate()) Node(); }
+        static void reclaim_node(void* node) {
+            static_cast<Node*>(node)->~Node();
+            Pool::deallocate(node);
+        }
+        void link(Node* node);
+
+    public:
+        ConcurrentQueue();
+        ConcurrentQueue(const ConcurrentQueue&) = delete;
+        ConcurrentQueue& operator= (const ConcurrentQueue&) = delete;
+
+        ~ConcurrentQueue(); // no other thread may use the queue anymore
+
+        void push(const T& element) { emplace(element); }
+        void push(T&& element) { emplace(std::move(element)); }
+        template<typename... Args>
+        void emplace(Args&&... args);
+        bool try_pop(T& element); // false if the queue was empty
+        bool empty() const noexcept; // only a snapshot while other threads push or pop
+    };
+
+    template<typename T>
+    ConcurrentQueue<T>::ConcurrentQueue() {
+        Node* dummy = create_node();
+        head.store(dummy, std::memory_order_relaxed);
+        tail.store(dummy, std::memory_order_relaxed);
+    }
+
+    template<typename T>
+    ConcurrentQueue<T>::~ConcurrentQueue() {
+        Node* cur = head.load(std::memory_order_relaxed);
+        Node* next = cur->next.load(std::memory_order_relaxed);
+        reclaim_node(cur);
+        for (cur = next; cur; cur = next) {
+            next = cur->next.load(std::memory_order_relaxed);
+            cur->value()->~T();
+            reclaim_node(cur);
+        }
+    }
+
+    template<typename T>
+    void ConcurrentQueue<T>::link(Node* node) {
+        while (true) {
+            Node* last = HazardPointers::protect(0, tail);
+            Node* next = last->next.load(std::memory_order_acquire);
+            if (last != tail.load(std::memory_order_acquire)) continue;
+
+            if (next) {
+                // another push linked its node but has not moved tail yet, help it
+                tail.compare_exchange_weak(last, next, std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+
+            Node* expected = nullptr;
+            if (last->next.compare_exchange_weak(expected, node, std::memory_order_release, std::memory_order_relaxed)) {
+                tail.compare_exchange_strong(last, node, std::memory_order_release, std::memory_order_relaxed);
+                break;
+            }
+        }
+        HazardPointers::clear(0);
+    }
+
+    template<typename T>
+    template<typename... Args>
+    void ConcurrentQueue<T>::emplace(Args&&... args) {
+        Node* node = create_node();
+        try {
+            ::new (node->storage) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            reclaim_node(node);
+            throw;
+        }
+        link(node);
+    }
+
+    template<typename T>
+    bool ConcurrentQueue<T>::try_pop(T& element) {
+        while (true) {
+            Node* first = HazardPointers::protect(0, head);
+            Node* next = HazardPointers::protect(1, first->next);
+            if (first != head.load(std::memory_order_acquire)) continue;
+
+            if (!next) {
+                HazardPointers::clear(0);
+                HazardPointers::clear(1);
+                return false;
+            }
+
+            Node* last = tail.load(std::memory_order_acquire);
+            if (first == last) {
+                // tail lags behind a node that is already linked
+                tail.compare_exchange_weak(last, next, std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+
+            if (head.compare_exchange_weak(first, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                // winning the exchange gives exclusive ownership of the value in next, which becomes the new dummy
+                element = std::move(*next->value());
+                next->value()->~T();
+                HazardPointers::clear(0);
+                HazardPointers::clear(1);
+                HazardPointers::retire(first, &reclaim_node);
+                return true;
+            }
+        }
+    }
+
+    template<typename T>
+    bool ConcurrentQueue<T>::empty() const noexcept {
+        Node* first = head.load(std::memory_order_acquire);
+        return first == tail.load(std::memory_order_acquire) && !first->next.load(std::memory_order_acquire);
+    }
+}
+
+#endif // !__CONCURRENT_QUEUE_HPP__
\ No newline at end of file
@@ -0,0 +1,384 @@
+﻿#pragma once
+#ifndef __CONCURRENT_SKIP_MAP_HPP__
+#define __CONCURRENT_SKIP_MAP_HPP__
+
+#include <utility>
+#include <stdexcept>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <compare>
+#include <functional>
+#include <type_traits>
+#include <cstdint>
+#include "Compare.hpp"
+#include "Reclamation.hpp"
+
+namespace My {
+    // ordered map for many threads: a lock-free skip list (Herlihy-Shavit) with the insert/at/count/iteration surface of My::Map.
+    // Erase marks the links of a node (the low pointer bit) before unlinking it, so an insert never links behind a removed node,
+    // unlinked nodes are reclaimed through Epoch. Values are boxed, so insert() on a present key swaps the value atomically.
+    // Iterators and for_each() are weakly consistent: they see every element that is present for the whole walk
+    // and may or may not see elements inserted or erased meanwhile.
+    template <typename T1, typename T2, typename Compare = DefaultCompare>
+    class ConcurrentSkipMap {
+        static constexpr int MAX_LEVEL = 16; // levels are chosen with p = 1/4, enough for 4^16 elements
+
+        struct Node {
+            Node(const T1& _key, T2* _value, int _top_level) : key(_key), value(_value), top_level(_top_level) {}
+
+            const T1 key;
+            std::atomic<T2*> value;
+            std::atomic<int> owners{ 2 }; // the inserter and the eraser, the last one to finish retires the node
+            int top_level;
+
+            // top_level + 1 links are placed right behind the node
+            std::atomic<Node*>* next() noexcept { return reinterpret_cast<std::atomic<Node*>*>(this + 1); }
+        };
+
+        std::atomic<Node*> head[MAX_LEVEL]; // links of the head sentinel
+        std::atomic<long long> sz{ 0 };
+        Compare comp;
+
+        static bool is_marked(Node* ptr) noexcept { return reinterpret_cast<std::uintptr_t>(ptr) & 1; }
+        static Node* marked(Node* ptr) noexcept { return reinterpret_cast<Node*>(reinterpret_cast<std::uintptr_t>(ptr) | 1); }
+        static Node* unmarked(Node* ptr) noexcept { return reinterpret_cast<Node*>(reinterpret_cast<std::uintptr_t>(ptr) & ~std::uintptr_t(1)); }
+
+        // nullptr stands for the head sentinel
+        std::atomic<Node*>& link(Node* pred, int level) const noexcept { return pred ? pred->next()[level] : const_cast<std::atomic<Node*>&>(head[level]); }
+
+        static Node* create_node(const T1& key, const T2& value, int top_level);
+        static void reclaim_node(void* node);
+        static void reclaim_value(void* value) { delete static_cast<T2*>(value); }
+        static int random_level() noexcept;
+        void release(Node* node) noexcept; // drops one owner share
+        int compare(const T1& lhs, const T1& rhs) const;
+        // fills preds and succs on every level around key, unlinks marked nodes on the way, true if succs[0] holds key
+        bool find(const T1& key, Node** preds, Node** succs);
+        // the first present node with a key not less than key (greater than key if strict), nullptr if there is none, needs a Guard
+        Node* lower_bound_node(const T1& key, bool strict) const;
+        Node* first_node() const; // needs a Guard
+        // inserts key if it is absent, otherwise assigns the value if assign is true or copies the present value to current
+        bool insert_impl(const T1& key, const T2& value, bool assign, T2* current);
+
+    public:
+        class iterator {
+            const ConcurrentSkipMap* this_map;
+            std::pair<T1, T2> val; // a copy, the node may be erased while the iterator points to it
+            bool at_end;
+        public:
+            iterator() : this_map(nullptr), at_end(true) {}
+            iterator(const ConcurrentSkipMap* _this_map, Node* node) : this_map(_this_map), at_end(!node) {
+                if (node) val = { node->key, *node->value.load() };
+            }
+            const std::pair<T1, T2>& operator*() const noexcept { return val; }
+            const std::pair<T1, T2>* operator->() const noexcept { return &val; }
+            iterator& operator++() {
+                // O(log n) per step: the walk restarts from the key, so it survives the erase of the current node
+                Epoch::Guard guard;
+                Node* node = this_map->lower_bound_node(val.first, true);
+                at_end = !node;
+                if (node) val = { node->key, *node->value.load() };
+                return *this;
+            }
+            iterator operator++(int) { iterator tmp = *this; ++*this; return tmp; }
+            bool operator==(const iterator& it) const {
+                if (at_end || it.at_end) return at_end == it.at_end;
+                return this_map->compare(val.first, it.val.first) == 0;
+            }
+            bool operator!=(const iterator& it) const { return !(*this == it); }
+        };
+
+        ConcurrentSkipMap(const Compare& _comp = Compare());
+        ConcurrentSkipMap(std::initializer_list<std::pair<T1, T2>> init_list, const Compare& _comp = Compare());
+        ConcurrentSkipMap(const ConcurrentSkipMap&) = delete;
+        ConcurrentSkipMap& operator=(const ConcurrentSkipMap&) = delete;
+
+        ~ConcurrentSkipMap(); // no other thread may use the map anymore
+
+        bool insert(const T1& key, const T2& value) { return insert_impl(key, value, true, nullptr); } // true if the key was inserted, false if assigned
+        bool insert(std::pair<T1, T2> value) { return insert(value.first, value.second); }
+        bool insert_if_absent(const T1& key, const T2& value) { return insert_impl(key, value, false, nullptr); } // never overwrites
+        T2 at(const T1& key); // a copy of the value, a missing key is inserted with T2() like in My::Map
+        bool find(const T1& key, T2& value) const; // copies the value out, false if the key is absent
+        bool count(const T1& key) const;
+        bool erase(const T1& key); // false if the key was absent
+        void clear(); // erases the elements one by one, may run concurrently with other operations
+        std::size_t size() const noexcept; // only a snapshot while other threads insert or erase
+        bool empty() const noexcept { return size() == 0; }
+        template<typename Function>
+        void for_each(Function f) const; // calls f(key, value) in key order, O(1) per element
+
+        iterator lower_bound(const T1& key) const;
+        iterator begin() const;
+        iterator end() const { return iterator(); }
+    };
+
+    template<typename T1, typename T2, typename Compare>
+    ConcurrentSkipMap<T1, T2, Compare>::ConcurrentSkipMap(const Compare& _comp) : comp(_comp) {
+        for (auto& level : head) level.store(nullptr, std::memory_order_relaxed);
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    ConcurrentSkipMap<T1, T2, Compare>::ConcurrentSkipMap(std::initializer_list<std::pair<T1, T2>> init_list, const Compare& _comp) : ConcurrentSkipMap(_comp) {
+        for (auto& el : init_list) {
+            insert(el);
+        }
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    ConcurrentSkipMap<T1, T2, Compare>::~ConcurrentSkipMap() {
+        // marked nodes are already retired, only the present ones still belong to the map
+        Node* cur = head[0].load(std::memory_order_relaxed);
+        while (cur) {
+            Node* next = cur->next()[0].load(std::memory_order_relaxed);
+            if (!is_marked(next)) reclaim_node(cur);
+            cur = unmarked(next);
+        }
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    typename ConcurrentSkipMap<T1, T2, Compare>::Node* ConcurrentSkipMap<T1, T2, Compare>::create_node(const T1& key, const T2& value, int top_level) {
+        static_assert(alignof(Node) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned keys are not supported");
+        T2* boxed = new T2(value);
+        void* raw;
+        try {
+            raw = ::operator new(sizeof(Node) + (top_level + 1) * sizeof(std::atomic<Node*>));
+        }
+        catch (...) {
+            delete boxed;
+            throw;
+        }
+
+        Node* node;
+        try {
+            node = ::new (raw) Node(key, boxed, top_level);
+        }
+        catch (...) {
+            ::operator delete(raw);
+            delete boxed;
+            throw;
+        }
+        for (int level = 0; level <= top_level; level++) ::new (node->next() + level) std::atomic<Node*>(nullptr);
+        return node;
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    void ConcurrentSkipMap<T1, T2, Compare>::reclaim_node(void* ptr) {
+        Node* node = static_cast<Node*>(ptr);
+        delete node->value.load(std::memory_order_relaxed);
+        node->~Node();
+        ::operator delete(ptr);
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    int ConcurrentSkipMap<T1, T2, Compare>::random_level() noexcept {
+        thread_local std::uint64_t state = 0x9E3779B97F4A7C15ull ^ reinterpret_cast<std::uintptr_t>(&state);
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        int level = 0;
+        for (std::uint64_t bits = state; level < MAX_LEVEL - 1 && (bits & 3) == 0; bits >>= 2) level++;
+        return level;
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    void ConcurrentSkipMap<T1, T2, Compare>::release(Node* node) noexcept {
+        if (node->owners.fetch_sub(1) == 1) Epoch::retire(node, &reclaim_node);
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    int ConcurrentSkipMap<T1, T2, Compare>::compare(const T1& lhs, const T1& rhs) const {
+        if constexpr (std::is_same_v<std::invoke_result_t<const Compare&, const T1&, const T1&>, bool>) {
+            if (comp(lhs, rhs)) return -1;
+            return comp(rhs, lhs) ? 1 : 0;
+        }
+        else {
+            auto order = comp(lhs, rhs);
+            return order < 0 ? -1 : (order > 0 ? 1 : 0);
+        }
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    bool ConcurrentSkipMap<T1, T2, Compare>::find(const T1& key, Node** preds, Node** succs) {
+    retry:
+        Node* pred = nullptr;
+        for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+            Node* cur = unmarked(link(pred, level).load());
+            while (cur) {
+                Node* succ = cur->next()[level].load();
+                if (is_marked(succ)) {
+                    // cur is being erased, unlink it on this level, a failed exchange means pred changed under us
+                    Node* expected = cur;
+                    if (!link(pred, level).compare_exchange_strong(expected, unmarked(succ))) goto retry;
+                    cur = unmarked(succ);
+                    continue;
+                }
+                if (compare(cur->key, key) >= 0) break;
+                pred = cur;
+                cur = succ;
+            }
+            preds[level] = pred;
+            succs[level] = cur;
+        }
+        return succs[0] && compare(succs[0]->key, key) == 0;
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    typename ConcurrentSkipMap<T1, T2, Compare>::Node* ConcurrentSkipMap<T1, T2, Compare>::lower_bound_node(const T1& key, bool strict) const {
+        // readers only skip marked nodes, the links of a marked node never change, so walking through it is safe
+        Node* pred = nullptr;
+        Node* cur = nullptr;
+        for (int level = MAX_LEVEL - 1; level >= 0; level--) {
+            cur = unmarked(link(pred, level).load());
+            while (cur) {
+                int order = compare(cur->key, key);
+                if (order > 0 || (order == 0 && !strict)) break;
+                pred = cur;
+                cur = unmarked(cur->next()[level].load());
+            }
+        }
+        while (cur && is_marked(cur->next()[0].load())) cur = unmarked(cur->next()[0].load());
+        return cur;
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    typename ConcurrentSkipMap<T1, T2, Compare>::Node* ConcurrentSkipMap<T1, T2, Compare>::first_node() const {
+        Node* cur = head[0].load();
+        while (cur && is_marked(cur->next()[0].load())) cur = unmarked(cur->next()[0].load());
+        return cur;
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    bool ConcurrentSkipMap<T1, T2, Compare>::insert_impl(const T1& key, const T2& value, bool assign, T2* current) {
+        Epoch::Guard guard;
+        Node* preds[MAX_LEVEL];
+        Node* succs[MAX_LEVEL];
+        Node* node = nullptr;
+        while (true) {
+            if (find(key, preds, succs)) {
+                if (node) reclaim_node(node); // never published
+                Node* found = succs[0];
+                if (assign) {
+                    T2* old = found->value.exchange(new T2(value));
+                    Epoch::retire(old, &reclaim_value);
+                }
+                else if (current) *current = *found->value.load();
+                return false;
+            }
+
+            if (!node) node = create_node(key, value, random_level());
+            for (int level = 0; level <= node->top_level; level++) node->next()[level].store(succs[level], std::memory_order_relaxed);
+            Node* expected = succs[0];
+            if (link(preds[0], 0).compare_exchange_strong(expected, node)) break; // the node is present from here on
+        }
+        sz.fetch_add(1, std::memory_order_relaxed);
+        if (current) *current = value;
+
+        // the upper levels only speed up the search, the walk stops as soon as the node is being erased
+        for (int level = 1; level <= node->top_level; level++) {
+            while (true) {
+                Node* next = node->next()[level].load();
+                if (is_marked(next)) goto linked;
+                if (next != succs[level] && !node->next()[level].compare_exchange_strong(next, succs[level])) goto linked;
+                Node* expected = succs[level];
+                if (link(preds[level], level).compare_exchange_strong(expected, node)) break;
+                find(key, preds, succs);
+                if (succs[0] != node) goto linked;
+            }
+        }
+    linked:
+        // an erase that ran while the levels were linked may have missed some of them, the find unlinks them
+        if (is_marked(node->next()[0].load())) find(key, preds, succs);
+        release(node);
+        return true;
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    T2 ConcurrentSkipMap<T1, T2, Compare>::at(const T1& key) {
+        T2 value;
+        if (find(key, value)) return value;
+        insert_impl(key, T2(), false, &value);
+        return value;
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    bool ConcurrentSkipMap<T1, T2, Compare>::find(const T1& key, T2& value) const {
+        Epoch::Guard guard;
+        Node* node = lower_bound_node(key, false);
+        if (!node || compare(node->key, key) != 0) return false;
+        value = *node->value.load();
+        return true;
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    bool ConcurrentSkipMap<T1, T2, Compare>::count(const T1& key) const {
+        Epoch::Guard guard;
+        Node* node = lower_bound_node(key, false);
+        return node && compare(node->key, key) == 0;
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    bool ConcurrentSkipMap<T1, T2, Compare>::erase(const T1& key) {
+        Epoch::Guard guard;
+        Node* preds[MAX_LEVEL];
+        Node* succs[MAX_LEVEL];
+        if (!find(key, preds, succs)) return false;
+        Node* victim = succs[0];
+
+        // upper levels first, so a search never reaches level 0 of the victim through a level that is still unmarked
+        for (int level = victim->top_level; level >= 1; level--) {
+            Node* next = victim->next()[level].load();
+            while (!is_marked(next) && !victim->next()[level].compare_exchange_weak(next, marked(next)));
+        }
+
+        // marking level 0 is the erase itself, exactly one thread wins it
+        Node* next = victim->next()[0].load();
+        while (true) {
+            if (is_marked(next)) return false; // another thread erased it first
+            if (victim->next()[0].compare_exchange_weak(next, marked(next))) break;
+        }
+        sz.fetch_sub(1, std::memory_order_relaxed);
+
+        find(key, preds, succs); // unlinks the victim on every level
+        release(victim);
+        return true;
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    void ConcurrentSkipMap<T1, T2, Compare>::clear() {
+        Epoch::Guard guard; // keeps the node alive while its key is passed to erase()
+        for (Node* node = first_node(); node; node = first_node()) erase(node->key);
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    std::size_t ConcurrentSkipMap<T1, T2, Compare>::size() const noexcept {
+        long long count = sz.load(std::memory_order_relaxed);
+        return count > 0 ? static_cast<std::size_t>(count) : 0; // an erase may be counted before the insert it undoes
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    template<typename Function>
+    void ConcurrentSkipMap<T1, T2, Compare>::for_each(Function f) const {
+        Epoch::Guard guard;
+        for (Node* cur = head[0].load(); cur; ) {
+            Node* next = cur->next()[0].load();
+            if (!is_marked(next)) f(cur->key, *cur->value.load());
+            cur = unmarked(next);
+        }
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    typename ConcurrentSkipMap<T1, T2, Compare>::iterator ConcurrentSkipMap<T1, T2, Compare>::lower_bound(const T1& key) const {
+        Epoch::Guard guard;
+        return iterator(this, lower_bound_node(key, false));
+    }
+
+    template<typename T1, typename T2, typename Compare>
+    typename ConcurrentSkipMap<T1, T2, Compare>::iterator ConcurrentSkipMap<T1, T2, Compare>::begin() const {
+        Epoch::Guard guard;
+        return iterator(this, first_node());
+    }
+}
+
+#endif // !__CONCURRENT_SKIP_MAP_HPP__
\ No newline at end of file
@@ -0,0 +1,111 @@
+﻿#pragma once
+#ifndef __COUNTERS_HPP__
+#define __COUNTERS_HPP__
+
+#include <type_traits>
+#include <cstddef>
+#include <atomic>
+#include <initializer_list>
+
+// Hot path counters of one container instance. They are collected only when MY_CONTAINERS_STATS is defined
+// (the CMake option of the same name defines it for every target that links my_containers), otherwise every
+// counting call is empty, the counters member takes no space and counters() returns zeros.
+// The macro must be the same in every translation unit of a program.
+namespace My {
+    struct Counters {
+        std::size_t allocations = 0; // calls to the allocator
+        std::size_t reallocations = 0; // storage moved to a larger block
+        std::size_t rehashes = 0;
+        std::size_t rotations = 0; // left and right tree rotations
+        std::size_t probe_steps = 0; // buckets visited after the home bucket
+        std::size_t copies = 0; // elements copy constructed or copy assigned by the container
+        std::size_t moves = 0; // elements move constructed or move assigned by the container
+    };
+
+#ifdef MY_CONTAINERS_STATS
+    inline constexpr bool counters_enabled = true;
+
+    class InstanceCounters {
+        // const lookups count probe steps too, and containers such as My::ConcurrentHashMap run them on several threads
+        // under a shared lock, so every counter is a relaxed atomic
+        struct Values {
+            std::atomic<std::size_t> allocations{ 0 };
+            std::atomic<std::size_t> reallocations{ 0 };
+            std::atomic<std::size_t> rehashes{ 0 };
+            std::atomic<std::size_t> rotations{ 0 };
+            std::atomic<std::size_t> probe_steps{ 0 };
+            std::atomic<std::size_t> copies{ 0 };
+            std::atomic<std::size_t> moves{ 0 };
+        };
+        mutable Values values;
+
+        static void add(std::atomic<std::size_t>& value, std::size_t n) noexcept { value.fetch_add(n, std::memory_order_relaxed); }
+        static std::size_t load(const std::atomic<std::size_t>& value) noexcept { return value.load(std::memory_order_relaxed); }
+    public:
+        InstanceCounters() = default;
+        // the counters belong to one instance, a copy starts from zero
+        InstanceCounters(const InstanceCounters&) noexcept {}
+        InstanceCounters& operator=(const InstanceCounters&) noexcept { return *this; }
+
+        void allocation(std::size_t n = 1) const noexcept { add(values.allocations, n); }
+        void reallocation() const noexcept { add(values.reallocations, 1); }
+        void rehash() const noexcept { add(values.rehashes, 1); }
+        void rotation() const noexcept { add(values.rotations, 1); }
+        void probe_step() const noexcept { add(values.probe_steps, 1); }
+        void copy(std::size_t n = 1) const noexcept { add(values.copies, n); }
+        void move(std::size_t n = 1) const noexcept { add(values.moves, n); }
+        // an element constructed from the forwarded arguments Args is a copy or a move when they are a single T
+        template<typename T, typename... Args>
+        void construction() const noexcept {
+            if constexpr (sizeof...(Args) == 1) single_construction<T, Args...>();
+        }
+
+        Counters get() const noexcept {
+            Counters result;
+            result.allocations = load(values.allocations);
+            result.reallocations = load(values.reallocations);
+            result.rehashes = load(values.rehashes);
+            result.rotations = load(values.rotations);
+            result.probe_steps = load(values.probe_steps);
+            result.copies = load(values.copies);
+            result.moves = load(values.moves);
+            return result;
+        }
+        void reset() noexcept {
+            for (auto* value : { &values.allocations, &values.reallocations, &values.rehashes, &values.rotations, &values.probe_steps, &values.copies, &values.moves }) {
+                value->store(0, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        template<typename T, typename Arg>
+        void single_construction() const noexcept {
+            using Source = std::remove_reference_t<Arg>;
+            if constexpr (std::is_same_v<std::remove_cv_t<Source>, T>) {
+                if (std::is_const_v<Source> || std::is_lvalue_reference_v<Arg>) add(values.copies, 1);
+                else add(values.moves, 1);
+            }
+        }
+    };
+#else
+    inline constexpr bool counters_enabled = false;
+
+    class InstanceCounters {
+    public:
+        void allocation(std::size_t = 1) const noexcept {}
+        void reallocation() const noexcept {}
+        void rehash() const noexcept {}
+        void rotation() const noexcept {}
+        void probe_step() const noexcept {}
+        void copy(std::size_t = 1) const noexcept {}
+        void move(std::size_t = 1) const noexcept {}
+        template<typename T, typename... Args>
+        void construction() const noexcept {}
+
+        Counters get() const noexcept { return Counters(); }
+        void reset() noexcept {}
+    };
+#endif
+}
+
+#endif // !__COUNTERS_HPP__
\ No newline at end of file
@@ -0,0 +1,348 @@
+﻿#pragma once
+#ifndef __DEQUE_HPP__
+#define __DEQUE_HPP__
+
+#include <stdexcept>
+#include <utility>
+#include <initializer_list>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <cstddef>
+
+namespace My {
+    // double-ended queue on fixed-size blocks that are reached through a map of block pointers,
+    // push and pop at both ends never move elements, so references to the other elements stay valid
+    template<typename T, typename Allocator = std::allocator<T>>
+    class Deque {
+        using MapAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<T*>;
+
+        static constexpr std::size_t block_shift = sizeof(T) <= 8 ? 6 : (sizeof(T) <= 32 ? 4 : 3);
+        static constexpr std::size_t block_size = std::size_t(1) << block_shift; // elements per block
+
+        T** map; // block pointers, unused entries are nullptr or spare blocks kept for reuse
+        std::size_t map_cp; // map capacity in blocks
+        std::size_t start; // position of the first element counted from the first element of map[0]
+        std::size_t sz; // size
+        Allocator alloc;
+        MapAllocator map_alloc;
+
+        T* slot(std::size_t position) const noexcept { return map[position >> block_shift] + (position & (block_size - 1)); }
+        void make_room(bool at_front);
+        void ensure_block(std::size_t block);
+        void release_map() noexcept;
+
+    public:
+        class iterator {
+            Deque* deque;
+            std::size_t index;
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            iterator() = default;
+            iterator(Deque* _deque, std::size_t _index) : deque(_deque), index(_index) {}
+            T& operator*() const noexcept { return *deque->slot(deque->start + index); }
+            T* operator->() const noexcept { return deque->slot(deque->start + index); }
+            T& operator[](difference_type offset) const noexcept { return *(*this + offset); }
+            bool operator==(const iterator& second) const noexcept { return index == second.index; }
+            bool operator!=(const iterator& second) const noexcept { return !(*this == second); }
+            bool operator<(const iterator& second) const noexcept { return index < second.index; }
+            bool operator>(const iterator& second) const noexcept { return second < *this; }
+            bool operator<=(const iterator& second) const noexcept { return !(second < *this); }
+            bool operator>=(const iterator& second) const noexcept { return !(*this < second); }
+            iterator& operator++() noexcept { ++index; return *this; }
+            iterator operator++(int) noexcept { iterator tmp = *this; ++*this; return tmp; }
+            iterator& operator--() noexcept { --index; return *this; }
+            iterator operator--(int) noexcept { iterator tmp = *this; --*this; return tmp; }
+            iterator operator+(difference_type offset) const noexcept { iterator tmp = *this; tmp.index += offset; return tmp; }
+            iterator operator-(difference_type offset) const noexcept { iterator tmp = *this; tmp.index -= offset; return tmp; }
+            difference_type operator-(const iterator& second) const noexcept { return static_cast<difference_type>(index) - static_cast<difference_type>(second.index); }
+            iterator& operator+=(difference_type offset) noexcept { index += offset; return *this; }
+            iterator& operator-=(difference_type offset) noexcept { index -= offset; return *this; }
+            friend iterator operator+(difference_type offset, const iterator& it) noexcept { return it + offset; }
+        };
+
+        Deque(const Allocator& _alloc = Allocator());
+        Deque(int size, const Allocator& _alloc = Allocator());
+        Deque(std::initializer_list<T> init_list, const Allocator& _alloc = Allocator());
+        Deque(std::size_t size, const T& value, const Allocator& _alloc = Allocator());
+        Deque(const Deque& other);
+        Deque(Deque&& other) noexcept;
+
+        ~Deque();
+
+        Deque& operator =(const Deque& other);
+        Deque& operator =(Deque&& other) noexcept;
+        T& operator[](std::size_t index) const;
+
+        void push_back(const T& element) { emplace_back(element); }
+        void push_back(T&& element) { emplace_back(std::move(element)); }
+        void push_front(const T& element) { emplace_front(element); }
+        void push_front(T&& element) { emplace_front(std::move(element)); }
+        template<typename... Args>
+        T& emplace_back(Args&&... args);
+        template<typename... Args>
+        T& emplace_front(Args&&... args);
+        void pop_back();
+        void pop_front();
+        std::size_t size() const noexcept { return sz; }
+        void resize(int size);
+        void clear();
+        void shrink_to_fit(); // frees the spare blocks and the unused part of the map
+        bool empty() const noexcept { return sz == 0; }
+        T& front() const;
+        T& back() const;
+        T& at(std::size_t index) const { return operator[](index); }
+
+        iterator begin() { return iterator(this, 0); };
+        iterator end() { return iterator(this, sz); };
+    };
+
+    template<typename T, typename Allocator>
+    void Deque<T, Allocator>::make_room(bool at_front) {
+        // called when the map has no entry left on the requested side
+        std::size_t first_block = start >> block_shift;
+        std::size_t used = sz ? ((start + sz - 1) >> block_shift) - first_block + 1 : 0;
+        std::size_t needed = used + 1;
+
+        if (needed * 2 > map_cp) {
+            std::size_t new_cp = std::max<std::size_t>(8, map_cp * 2);
+            T** new_map = map_alloc.allocate(new_cp);
+            std::fill(new_map, new_map + new_cp, nullptr);
+            std::size_t offset = (new_cp - map_cp) / 2;
+            if (map) {
+                std::copy(map, map + map_cp, new_map + offset);
+                map_alloc.deallocate(map, map_cp);
+            }
+            map = new_map;
+            map_cp = new_cp;
+            first_block += offset;
+            start += offset * block_size;
+        }
+
+        // center the used blocks and leave the new block on the requested side, the rotation keeps spare blocks in the map
+        std::size_t new_first = (map_cp - needed) / 2 + (at_front ? 1 : 0);
+        if (new_first < first_block) std::rotate(map, map + (first_block - new_first), map + map_cp);
+        else if (new_first > first_block) std::rotate(map, map + map_cp - (new_first - first_block), map + map_cp);
+        start = start - first_block * block_size + new_first * block_size;
+    }
+
+    template<typename T, typename Allocator>
+    void Deque<T, Allocator>::ensure_block(std::size_t block) {
+        if (!map[block]) map[block] = alloc.allocate(block_size);
+    }
+
+    template<typename T, typename Allocator>
+    void Deque<T, Allocator>::release_map() noexcept {
+        if (!map) return;
+        for (std::size_t i = 0; i < map_cp; i++) {
+            if (map[i]) alloc.deallocate(map[i], block_size);
+        }
+        map_alloc.deallocate(map, map_cp);
+        map = nullptr;
+        map_cp = 0;
+        start = 0;
+    }
+
+    template<typename T, typename Allocator>
+    Deque<T, Allocator>::Deque(const Allocator& _alloc) : map(nullptr), map_cp(0), start(0), sz(0), alloc(_alloc), map_alloc(_alloc) {}
+
+    template<typename T, typename Allocator>
+    Deque<T, Allocator>::Deque(int size, const Allocator& _alloc) : Deque(_alloc) {
+        if (size < 0) throw std::length_error("size must be greater than 0."); // EXCEPTION
+        try {
+            for (int i = 0; i < size; i++) emplace_back();
+        }
+        catch (...) {
+            clear();
+            release_map();
+            throw;
+        }
+    }
+
+    template<typename T, typename Allocator>
+    Deque<T, Allocator>::Deque(std::initializer_list<T> init_list, const Allocator& _alloc) : Deque(_alloc) {
+        try {
+            for (auto& el : init_list) emplace_back(el);
+        }
+        catch (...) {
+            clear();
+            release_map();
+            throw;
+        }
+    }
+
+    template<typename T, typename Allocator>
+    Deque<T, Allocator>::Deque(std::size_t size, const T& value, const Allocator& _alloc) : Deque(_alloc) {
+        try {
+            for (std::size_t i = 0; i < size; i++) emplace_back(value);
+        }
+        catch (...) {
+            clear();
+            release_map();
+            throw;
+        }
+    }
+
+    template<typename T, typename Allocator>
+    Deque<T, Allocator>::Deque(const Deque& other) : Deque(other.alloc) {
+        try {
+            for (std::size_t i = 0; i < other.sz; i++) emplace_back(*other.slot(other.start + i));
+        }
+        catch (...) {
+            clear();
+            release_map();
+            throw;
+        }
+    }
+
+    template<typename T, typename Allocator>
+    Deque<T, Allocator>::Deque(Deque&& other) noexcept : map(other.map), map_cp(other.map_cp), start(other.start), sz(other.sz), alloc(std::move(other.alloc)), map_alloc(std::move(other.map_alloc)) {
+        other.map = nullptr;
+        other.map_cp = 0;
+        other.start = 0;
+        other.sz = 0;
+    }
+
+    template<typename T, typename Allocator>
+    Deque<T, Allocator>::~Deque() {
+        clear();
+        release_map();
+    }
+
+    template<typename T, typename Allocator>
+    Deque<T, Allocator>& Deque<T, Allocator>::operator =(const Deque& other) {
+        if (this != &other) {
+            clear();
+            for (std::size_t i = 0; i < other.sz; i++) emplace_back(*other.slot(other.start + i));
+        }
+        return *this;
+    }
+
+    template<typename T, typename Allocator>
+    Deque<T, Allocator>& Deque<T, Allocator>::operator =(Deque&& other) noexcept {
+        if (this != &other) {
+            clear();
+            release_map();
+
+            map = other.map;
+            map_cp = other.map_cp;
+            start = other.start;
+            sz = other.sz;
+            alloc = std::move(other.alloc);
+            map_alloc = std::move(other.map_alloc);
+            other.map = nullptr;
+            other.map_cp = 0;
+            other.start = 0;
+            other.sz = 0;
+        }
+        return *this;
+    }
+
+    template<typename T, typename Allocator>
+    T& Deque<T, Allocator>::operator[](std::size_t index) const {
+        if (index >= sz) throw std::out_of_range("out of the range."); // EXCEPTION
+        return *slot(start + index);
+    }
+
+    template<typename T, typename Allocator>
+    template<typename... Args>
+    T& Deque<T, Allocator>::emplace_back(Args&&... args) {
+        std::size_t position = start + sz;
+        if (position == map_cp * block_size) {
+            make_room(false);
+            position = start + sz;
+        }
+        ensure_block(position >> block_shift);
+
+        T* place = slot(position);
+        std::allocator_traits<Allocator>::construct(alloc, place, std::forward<Args>(args)...);
+        sz++;
+        return *place;
+    }
+
+    template<typename T, typename Allocator>
+    template<typename... Args>
+    T& Deque<T, Allocator>::emplace_front(Args&&... args) {
+        if (start == 0) make_room(true);
+        std::size_t position = start - 1;
+        ensure_block(position >> block_shift);
+
+        T* place = slot(position);
+        std::allocator_traits<Allocator>::construct(alloc, place, std::forward<Args>(args)...);
+        start = position;
+        sz++;
+        return *place;
+    }
+
+    template<typename T, typename Allocator>
+    void Deque<T, Allocator>::pop_back() {
+        if (!sz) throw std::out_of_range("pop_back called on empty deque."); // EXCEPTION
+        std::allocator_traits<Allocator>::destroy(alloc, slot(start + sz - 1));
+        sz--;
+    }
+
+    template<typename T, typename Allocator>
+    void Deque<T, Allocator>::pop_front() {
+        if (!sz) throw std::out_of_range("pop_front called on empty deque."); // EXCEPTION
+        std::allocator_traits<Allocator>::destroy(alloc, slot(start));
+        start++;
+        sz--;
+    }
+
+    template<typename T, typename Allocator>
+    void Deque<T, Allocator>::resize(int size) {
+        if (size < 0) throw std::length_error("size must be greater than 0."); // EXCEPTION
+        while (sz < static_cast<std::size_t>(size)) emplace_back();
+        while (sz > static_cast<std::size_t>(size)) pop_back();
+    }
+
+    template<typename T, typename Allocator>
+    void Deque<T, Allocator>::clear() {
+        for (std::size_t i = 0; i < sz; i++) {
+            std::allocator_traits<Allocator>::destroy(alloc, slot(start + i));
+        }
+        sz = 0;
+        start = map_cp / 2 * block_size; // an empty deque grows equally well in both directions
+    }
+
+    template<typename T, typename Allocator>
+    void Deque<T, Allocator>::shrink_to_fit() {
+        if (!map) return;
+        if (sz == 0) {
+            release_map();
+            return;
+        }
+
+        std::size_t first_block = start >> block_shift;
+        std::size_t last_block = (start + sz - 1) >> block_shift;
+        std::size_t used = last_block - first_block + 1;
+        T** new_map = map_alloc.allocate(used);
+        std::copy(map + first_block, map + last_block + 1, new_map);
+        for (std::size_t i = 0; i < map_cp; i++) {
+            if (map[i] && (i < first_block || i > last_block)) alloc.deallocate(map[i], block_size);
+        }
+        map_alloc.deallocate(map, map_cp);
+        map = new_map;
+        map_cp = used;
+        start -= first_block * block_size;
+    }
+
+    template<typename T, typename Allocator>
+    T& Deque<T, Allocator>::front() const {
+        if (!sz) throw std::out_of_range("front called on empty deque."); // EXCEPTION
+        return *slot(start);
+    }
+
+    template<typename T, typename Allocator>
+    T& Deque<T, Allocator>::back() const {
+        if (!sz) throw std::out_of_range("back called on empty deque."); // EXCEPTION
+        return *slot(start + sz - 1);
+    }
+}
+
+#endif // !__DEQUE_HPP__
\ No newline at end of file
@@ -0,0 +1,1144 @@
+﻿#pragma once
+#ifndef __HASHMAP_HPP__
+#define __HASHMAP_HPP__
+
+#include "HashStats.hpp"
+#include "Counters.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace My {
+    template <typename T1, typename T2, typename Hash = std::hash<T1>, typename Allocator = std::allocator<std::pair<T1, T2>>>
+    class HashMap {
+    private:
+        const std::size_t DEFAULT_NUMBER_OF_BUCKETS = 8;
+        const std::size_t FACTOR_OF_REHASHING = 2;
+        const float REHASHING_COEFFICIENT = 0.7f;
+        static constexpr std::size_t MIN_PARALLEL_RANGE = std::size_t(1) << 14; // buckets per thread, smaller tables are not worth a thread
+        static constexpr std::size_t MIN_REHASH_STEP = 8;
+        // new buckets constructed per bucket of the step, so the new table is ready long before the current one fills up
+        static constexpr std::size_t CONSTRUCTED_PER_STEP = 4;
+
+        enum class BucketState { ABSENT, PRESENT, DELETED };
+
+        std::pair<T1, T2>* table;
+        BucketState* flag;
+        Allocator alloc;
+        std::allocator<BucketState> state_alloc;
+        Hash hash;
+
+        std::size_t number_of_buckets;
+        std::size_t buckets_used; // elements and tombstones
+        std::size_t sz; // elements
+        RehashHook rehash_hook;
+        std::size_t rehash_threads = 1; // used by the rehash that insert() starts
+        // an incremental rehash, see set_rehash_step(): the larger table is constructed a few buckets per operation while
+        // the map keeps using the current one, then it becomes the table and the elements move over from old_table
+        struct IncrementalRehash {
+            std::size_t step = 0; // old buckets per operation, 0 rehashes at once
+            std::pair<T1, T2>* next_table = nullptr;
+            BucketState* next_flag = nullptr;
+            std::size_t next_number_of_buckets = 0;
+            std::size_t constructed = 0; // buckets of next_table
+            std::pair<T1, T2>* old_table = nullptr;
+            BucketState* old_flag = nullptr;
+            std::size_t old_number_of_buckets = 0;
+            std::size_t migrated = 0; // the old buckets before this one are moved, only tombstones are left there
+            std::size_t tombstones_dropped = 0;
+        } incremental;
+        [[no_unique_address]] InstanceCounters counter;
+        void* mapping = nullptr; // the snapshot file that table and flag point into, see open_mapped()
+        std::size_t mapping_length = 0;
+
+        // layout of a file written by save(): this header, then table and flag exactly as they are in memory
+        static constexpr std::uint32_t SNAPSHOT_VERSION = 1;
+        struct SnapshotHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t byte_order; // 0x01020304 as stored by the machine that saved the table
+            std::uint64_t key_size;
+            std::uint64_t value_size;
+            std::uint64_t entry_size;
+            std::uint64_t entry_alignment;
+            std::uint64_t state_size;
+            std::uint64_t number_of_buckets;
+            std::uint64_t size;
+            std::uint64_t buckets_used;
+            std::uint64_t hash_check; // the hashes of the first keys of the table, the hash function has no seed of its own
+            std::uint64_t table_offset;
+            std::uint64_t flag_offset;
+            std::uint64_t file_size;
+        };
+
+        enum class Placement { INSERTED, ASSIGNED, FULL };
+
+        void rehash();
+        void rehash_sequential();
+        void start_incremental_rehash(); // allocates the next table, nothing is constructed yet
+        void advance_rehash(std::size_t buckets); // constructs CONSTRUCTED_PER_STEP * buckets new buckets or migrates buckets old ones
+        void drop_rehash(); // releases the tables of an incremental rehash without migrating, the elements in old_table are lost
+        void migrate(std::pair<T1, T2>& element); // into the table, the key is known to be absent
+        void create_new_table(const T1& key, const T2& value);
+        void allocate_table(std::size_t buckets, std::size_t threads); // a new empty table, the old one must have been released or saved
+        // probes from index up to range_end only, so threads that own different ranges never touch the same bucket
+        template<typename Element> Placement place_in_range(std::size_t index, std::size_t range_end, Element&& element);
+        template<typename Function> static void run_threads(std::size_t threads, Function f); // f(0) .. f(threads - 1) at once
+        std::size_t find_index(const T1& key) const; // bucket of the key or number_of_buckets if it is absent
+        std::size_t find_old_index(const T1& key) const; // the same in old_table while migrating
+        std::pair<T1, T2>* locate(const T1& key) const; // the element in either table or nullptr
+        // iterators count the buckets of old_table after those of the table
+        std::size_t next_present(std::size_t index) const noexcept; // the first element bucket at or after index
+        bool present(std::size_t index) const noexcept;
+        std::pair<T1, T2>& element(std::size_t index) const noexcept;
+        // the elements before destroyed have been destroyed already
+        void release_table(std::pair<T1, T2>* old_table, BucketState* old_flag, std::size_t old_number_of_buckets, std::size_t destroyed = 0);
+        std::uint64_t hash_check() const;
+        SnapshotHeader snapshot_header() const;
+        static bool valid_snapshot(const SnapshotHeader& header, std::uint64_t file_size);
+
+    public:
+        HashMap(const Hash& _hash = Hash(), const Allocator& _alloc = Allocator());
+        HashMap(int size, const Hash& _hash = Hash(), const Allocator& _alloc = Allocator());
+        HashMap(std::initializer_list<std::pair<T1, T2>> init_list, const Hash& _hash = Hash(), const Allocator& _alloc = Allocator());
+        HashMap(const HashMap& other);
+        HashMap(HashMap&& other) noexcept;
+
+        ~HashMap();
+
+        HashMap& operator = (const HashMap& other);
+        HashMap& operator = (HashMap&& other) noexcept;
+        T2& operator [](const T1& key);
+
+        void insert(const T1& key, const T2& value);
+        void insert(std::pair<T1, T2> pair_key_value);
+        void erase(const T1& key);
+        T2& at(const T1& key);
+        void clear();
+        std::size_t size() const noexcept;
+        std::size_t bucket_count() const noexcept;
+        bool empty() const noexcept;
+        int bucket(const T1& key) const noexcept; // -1 if the key is absent or still in the old table of an incremental rehash
+        bool count(const T1& key) const noexcept;
+        T2* find(const T1& key); // nullptr if the key is absent, unlike at() it never inserts
+        const T2* find(const T1& key) const;
+        template<typename Function>
+        void for_each(Function f) const; // calls f(key, value) for every element straight from the table
+        HashStats stats() const; // probe lengths, tombstones and clustering of the table, O(bucket_count), not of an old table being migrated
+        Counters counters() const noexcept { return counter.get(); } // zeros unless MY_CONTAINERS_STATS is defined
+        void reset_counters() noexcept { counter.reset(); }
+        void set_rehash_hook(RehashHook hook); // called after every rehash, an empty function removes the hook
+
+        // multithreaded loading and growth: the buckets are split into one contiguous range per thread and every thread
+        // places the elements whose home bucket is in its range, elements that would probe past the end of their range
+        // are placed afterwards by the calling thread
+        // builds the map from [first, last) of key/value pairs, for equal keys the last one wins like with insert()
+        template<typename RandomIt>
+        static HashMap build_parallel(RandomIt first, RandomIt last, unsigned threads = std::thread::hardware_concurrency(), const Hash& _hash = Hash(), const Allocator& _alloc = Allocator());
+        void rehash_parallel(unsigned threads = std::thread::hardware_concurrency()); // doubles the table now
+        void set_rehash_threads(unsigned threads) noexcept { rehash_threads = threads ? threads : 1; } // for the rehash started by insert(), 1 by default
+
+        // incremental rehashing, off (0) by default: when insert() crosses the load threshold the doubled table is built and
+        // filled a bounded number of buckets at a time by every insert(), erase(), at() and non-const find(), so no single
+        // operation pays for the whole table; lookups search both tables until the migration completes and, unlike with
+        // std::unordered_map, may then move elements and invalidate iterators
+        void set_rehash_step(std::size_t buckets); // old buckets migrated per operation, at least MIN_REHASH_STEP; 0 finishes a pending rehash
+        bool rehashing() const noexcept { return incremental.next_table || incremental.old_table; }
+        void finish_rehash(); // completes a pending incremental rehash at once
+        void display() const; // additional method to display hash-table and bucket status, works only with primitive data types
+
+        // snapshots, only for trivially copyable keys and values
+        void save(const std::string& path) const; // writes the table as it is in memory, see SnapshotHeader; not while migrating
+        // maps a file written by save() copy-on-write without touching the elements, pages are read when they are first probed;
+        // the map can be changed like any other, changes are never written back to the file
+        static HashMap open_mapped(const std::string& path, const Hash& _hash = Hash(), const Allocator& _alloc = Allocator());
+
+        // walks the table and skips empty and erased buckets
+        class iterator {
+            HashMap* this_map;
+            std::size_t index;
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = std::pair<T1, T2>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::pair<T1, T2>*;
+            using reference = const std::pair<T1, T2>&;
+
+            iterator() = default;
+            iterator(HashMap* _this_map, std::size_t _index) : this_map(_this_map), index(_index) {}
+            const std::pair<T1, T2>& operator* () const { return this_map->element(index); }
+            const std::pair<T1, T2>* operator-> () const { return &this_map->element(index); }
+            iterator& operator++ () { index = this_map->next_present(index + 1); return *this; }
+            iterator operator++ (int) { iterator tmp = *this; ++* this; return tmp; }
+            iterator& operator-- () {
+                do index--; while (!this_map->present(index));
+                return *this;
+            }
+            iterator operator-- (int) { iterator tmp = *this; --* this; return tmp; }
+            bool operator== (const iterator& it) const { return index == it.index; }
+            bool operator!= (const iterator& it) const { return !(*this == it); }
+        };
+
+        iterator begin() { return iterator(this, next_present(0)); }
+        iterator end() { return iterator(this, number_of_buckets + incremental.old_number_of_buckets); }
+    };
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    HashMap<T1, T2, Hash, Allocator>::HashMap(const Hash& _hash, const Allocator& _alloc) : hash(_hash), alloc(_alloc) {
+        number_of_buckets = DEFAULT_NUMBER_OF_BUCKETS;
+        buckets_used = 0;
+        sz = 0;
+
+        table = alloc.allocate(number_of_buckets);
+        flag = state_alloc.allocate(number_of_buckets);
+        counter.allocation(2);
+        for (std::size_t i = 0; i < number_of_buckets; i++) {
+            std::allocator_traits<Allocator>::construct(alloc, table + i);
+            std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + i);
+        }
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    HashMap<T1, T2, Hash, Allocator>::HashMap(int size, const Hash& _hash, const Allocator& _alloc) : hash(_hash), alloc(_alloc) {
+        if (size <= 0) throw std::length_error("Table size must be greater then 0."); // EXCEPTION
+        number_of_buckets = size;
+        buckets_used = 0;
+        sz = 0;
+
+        table = alloc.allocate(number_of_buckets);
+        flag = state_alloc.allocate(number_of_buckets);
+        counter.allocation(2);
+        for (std::size_t i = 0; i < number_of_buckets; i++) {
+            std::allocator_traits<Allocator>::construct(alloc, table + i);
+            std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + i);
+        }
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    HashMap<T1, T2, Hash, Allocator>::HashMap(std::initializer_list<std::pair<T1, T2>> init_list, const Hash& _hash, const Allocator& _alloc) : HashMap<T1, T2, Hash, Allocator>::HashMap(init_list.size(), _hash, _alloc) {
+        for (auto& el : init_list) {
+            insert(el);
+        }
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    HashMap<T1, T2, Hash, Allocator>::HashMap(const HashMap& other) {
+        number_of_buckets = other.number_of_buckets;
+        buckets_used = other.buckets_used;
+        sz = other.sz;
+        alloc = other.alloc;
+        hash = other.hash;
+        rehash_hook = other.rehash_hook;
+        rehash_threads = other.rehash_threads;
+        incremental.step = other.incremental.step;
+        if (other.table && other.flag && other.incremental.old_table) {
+            // the elements are spread over two tables, the copy gets them in one
+            table = nullptr;
+            flag = nullptr;
+            allocate_table(number_of_buckets, 1);
+            buckets_used = sz;
+            other.for_each([this](const T1& key, const T2& value) { create_new_table(key, value); });
+        }
+        else if (other.table && other.flag) {
+            table = alloc.allocate(number_of_buckets);
+            flag = state_alloc.allocate(number_of_buckets);
+            counter.allocation(2);
+            counter.copy(number_of_buckets);
+            for (std::size_t i = 0; i < number_of_buckets; i++)
+            {
+                std::allocator_traits<Allocator>::construct(alloc, table + i, other.table[i]);
+                std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + i, other.flag[i]);
+            }
+        }
+        else {
+            table = nullptr;
+            flag = nullptr;
+        }
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    HashMap<T1, T2, Hash, Allocator>::HashMap(HashMap&& other) noexcept {
+        number_of_buckets = other.number_of_buckets;
+        buckets_used = other.buckets_used;
+        sz = other.sz;
+        table = other.table;
+        flag = other.flag;
+        mapping = other.mapping;
+        mapping_length = other.mapping_length;
+        hash = std::move(other.hash);
+        alloc = std::move(other.alloc);
+        rehash_hook = std::move(other.rehash_hook);
+        rehash_threads = other.rehash_threads;
+        incremental = other.incremental;
+
+        other.incremental = IncrementalRehash();
+        other.number_of_buckets = 0;
+        other.buckets_used = 0;
+        other.sz = 0;
+        other.table = nullptr;
+        other.flag = nullptr;
+        other.mapping = nullptr;
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    HashMap<T1, T2, Hash, Allocator>::~HashMap() {
+        drop_rehash();
+        release_table(table, flag, number_of_buckets);
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    HashMap<T1, T2, Hash, Allocator>& HashMap<T1, T2, Hash, Allocator>::operator = (const HashMap& other) {
+        if (this != &other) {
+            drop_rehash();
+            release_table(table, flag, number_of_buckets);
+
+            number_of_buckets = other.number_of_buckets;
+            buckets_used = other.buckets_used;
+            sz = other.sz;
+            hash = other.hash;
+            alloc = other.alloc;
+            rehash_hook = other.rehash_hook;
+            rehash_threads = other.rehash_threads;
+            incremental.step = other.incremental.step;
+            if (other.table && other.flag && other.incremental.old_table) {
+                table = nullptr;
+                flag = nullptr;
+                allocate_table(number_of_buckets, 1);
+                buckets_used = sz;
+                other.for_each([this](const T1& key, const T2& value) { create_new_table(key, value); });
+            }
+            else if (other.table && other.flag) {
+                table = alloc.allocate(number_of_buckets);
+                flag = state_alloc.allocate(number_of_buckets);
+                counter.allocation(2);
+                counter.copy(number_of_buckets);
+                for (std::size_t i = 0; i < number_of_buckets; i++)
+                {
+                    std::allocator_traits<Allocator>::construct(alloc, table + i, other.table[i]);
+                    std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + i, other.flag[i]);
+                }
+            }
+            else {
+                table = nullptr;
+                flag = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    HashMap<T1, T2, Hash, Allocator>& HashMap<T1, T2, Hash, Allocator>::operator = (HashMap&& other) noexcept {
+        if (this != &other) {
+            drop_rehash();
+            release_table(table, flag, number_of_buckets);
+
+            number_of_buckets = other.number_of_buckets;
+            buckets_used = other.buckets_used;
+            sz = other.sz;
+            table = other.table;
+            flag = other.flag;
+            mapping = other.mapping;
+            mapping_length = other.mapping_length;
+            hash = std::move(other.hash);
+            alloc = std::move(other.alloc);
+            rehash_hook = std::move(other.rehash_hook);
+            rehash_threads = other.rehash_threads;
+            incremental = other.incremental;
+
+            other.incremental = IncrementalRehash();
+            other.number_of_buckets = 0;
+            other.buckets_used = 0;
+            other.sz = 0;
+            other.table = nullptr;
+            other.flag = nullptr;
+            other.mapping = nullptr;
+        }
+        return *this;
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    T2& HashMap<T1, T2, Hash, Allocator>::operator [](const T1& key) { return at(key); }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::rehash() {
+        if (incremental.step) start_incremental_rehash();
+        else if (rehash_threads > 1) rehash_parallel(static_cast<unsigned>(rehash_threads));
+        else rehash_sequential();
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::start_incremental_rehash() {
+        IncrementalRehash& r = incremental;
+        r.next_number_of_buckets = number_of_buckets * FACTOR_OF_REHASHING;
+        r.next_table = alloc.allocate(r.next_number_of_buckets);
+        try {
+            r.next_flag = state_alloc.allocate(r.next_number_of_buckets);
+        }
+        catch (...) {
+            alloc.deallocate(r.next_table, r.next_number_of_buckets);
+            r.next_table = nullptr;
+            r.next_number_of_buckets = 0;
+            throw;
+        }
+        r.constructed = 0;
+        counter.allocation(2);
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::advance_rehash(std::size_t buckets) {
+        IncrementalRehash& r = incremental;
+        if (r.next_table) {
+            std::size_t end = r.constructed + std::min(r.next_number_of_buckets - r.constructed, buckets * CONSTRUCTED_PER_STEP);
+            for (; r.constructed < end; r.constructed++) {
+                std::allocator_traits<Allocator>::construct(alloc, r.next_table + r.constructed);
+                std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, r.next_flag + r.constructed);
+            }
+            if (r.constructed < r.next_number_of_buckets) return;
+
+            // the new table is ready, from now on elements are inserted there and the old ones follow
+            counter.rehash();
+            r.old_table = table;
+            r.old_flag = flag;
+            r.old_number_of_buckets = number_of_buckets;
+            r.migrated = 0;
+            r.tombstones_dropped = 0;
+            table = r.next_table;
+            flag = r.next_flag;
+            number_of_buckets = r.next_number_of_buckets;
+            buckets_used = 0;
+            r.next_table = nullptr;
+            r.next_flag = nullptr;
+            r.next_number_of_buckets = 0;
+            r.constructed = 0;
+        }
+        else if (r.old_table) {
+            std::size_t end = r.migrated + std::min(r.old_number_of_buckets - r.migrated, buckets);
+            for (; r.migrated < end; r.migrated++) {
+                if (r.old_flag[r.migrated] == BucketState::PRESENT) migrate(r.old_table[r.migrated]);
+                else if (r.old_flag[r.migrated] == BucketState::DELETED) r.tombstones_dropped++;
+                r.old_flag[r.migrated] = BucketState::DELETED;
+                // destroyed right away, so completing the migration does not pay for the whole old table
+                std::allocator_traits<Allocator>::destroy(alloc, r.old_table + r.migrated);
+            }
+            if (r.migrated < r.old_number_of_buckets) return;
+
+            std::size_t old_number_of_buckets = r.old_number_of_buckets;
+            std::size_t tombstones_dropped = r.tombstones_dropped;
+            release_table(r.old_table, r.old_flag, r.old_number_of_buckets, r.old_number_of_buckets);
+            r.old_table = nullptr;
+            r.old_flag = nullptr;
+            r.old_number_of_buckets = 0;
+            r.migrated = 0;
+            if (rehash_hook) rehash_hook({ old_number_of_buckets, number_of_buckets, size(), tombstones_dropped });
+        }
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::migrate(std::pair<T1, T2>& element) {
+        std::size_t index = hash(element.first) % number_of_buckets;
+        while (flag[index] != BucketState::ABSENT) {
+            index++;
+            counter.probe_step();
+            if (index >= number_of_buckets) {
+                index = 0;
+            }
+        }
+        if constexpr (std::is_nothrow_move_assignable_v<std::pair<T1, T2>>) {
+            table[index] = std::move(element);
+            counter.move();
+        }
+        else {
+            table[index] = element;
+            counter.copy();
+        }
+        flag[index] = BucketState::PRESENT;
+        buckets_used++;
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::drop_rehash() {
+        IncrementalRehash& r = incremental;
+        if (r.next_table) {
+            for (std::size_t i = 0; i < r.constructed; i++) {
+                std::allocator_traits<Allocator>::destroy(alloc, r.next_table + i);
+                std::allocator_traits<std::allocator<BucketState>>::destroy(state_alloc, r.next_flag + i);
+            }
+            alloc.deallocate(r.next_table, r.next_number_of_buckets);
+            state_alloc.deallocate(r.next_flag, r.next_number_of_buckets);
+        }
+        // a mapped snapshot can only be the old table here, so release_table() unmaps the right one
+        if (r.old_table) release_table(r.old_table, r.old_flag, r.old_number_of_buckets, r.migrated);
+        std::size_t step = r.step;
+        r = IncrementalRehash();
+        r.step = step;
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::set_rehash_step(std::size_t buckets) {
+        if (!buckets) finish_rehash();
+        incremental.step = buckets ? std::max(buckets, MIN_REHASH_STEP) : 0;
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::finish_rehash() {
+        // one call constructs the whole next table, the next one migrates the whole old table
+        while (rehashing()) advance_rehash(number_of_buckets * FACTOR_OF_REHASHING);
+    }
+
+    template <typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::rehash_sequential() {
+        counter.rehash();
+        std::pair<T1, T2>* copy_of_table = std::move(table);
+        BucketState* copy_of_flag = std::move(flag);
+        size_t old_number_of_buckets = number_of_buckets;
+        number_of_buckets = number_of_buckets * FACTOR_OF_REHASHING;
+        std::size_t tombstones_dropped = 0;
+
+        table = alloc.allocate(number_of_buckets);
+        flag = state_alloc.allocate(number_of_buckets);
+        counter.allocation(2);
+        for (std::size_t i = 0; i < number_of_buckets; i++) {
+            std::allocator_traits<Allocator>::construct(alloc, table + i);
+            std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + i);
+        }
+
+        for (std::size_t i = 0; i < old_number_of_buckets; i++) {
+            if (copy_of_flag[i] == BucketState::DELETED) {
+                std::allocator_traits<Allocator>::destroy(alloc, copy_of_flag + i);
+                std::allocator_traits<std::allocator<BucketState>>::destroy(state_alloc, copy_of_flag + i);
+                buckets_used--;
+                tombstones_dropped++;
+            }
+            if (copy_of_flag[i] == BucketState::DELETED) {
+                std::allocator_traits<Allocator>::construct(alloc, copy_of_flag + i);
+                std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, copy_of_flag + i, BucketState::ABSENT);
+            }
+            if (copy_of_flag[i] == BucketState::PRESENT)
+                create_new_table(copy_of_table[i].first, copy_of_table[i].second);
+        }
+
+        release_table(copy_of_table, copy_of_flag, old_number_of_buckets);
+
+        if (rehash_hook) rehash_hook({ old_number_of_buckets, number_of_buckets, size(), tombstones_dropped });
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::create_new_table(const T1& key, const T2& value) {
+        size_t index = hash(key) % number_of_buckets;
+        while (true) {
+            if (flag[index] == BucketState::ABSENT) {
+                std::allocator_traits<Allocator>::destroy(alloc, table + index);
+                std::allocator_traits<std::allocator<BucketState>>::destroy(state_alloc, flag + index);
+            }
+            if (flag[index] == BucketState::ABSENT) {
+                std::allocator_traits<Allocator>::construct(alloc, table + index, std::make_pair(key, value));
+                std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + index, BucketState::PRESENT);
+                counter.copy();
+                break;
+            }
+            else {
+                index++;
+                counter.probe_step();
+                if (index >= number_of_buckets) {
+                    index = 0;
+                }
+            };
+        }
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    template<typename Function>
+    void HashMap<T1, T2, Hash, Allocator>::run_threads(std::size_t threads, Function f) {
+        std::mutex error_lock;
+        std::exception_ptr error;
+        auto work = [&f, &error_lock, &error](std::size_t index) {
+            try {
+                f(index);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> guard(error_lock);
+                if (!error) error = std::current_exception();
+            }
+        };
+        std::vector<std::thread> workers;
+        try {
+            for (std::size_t t = 1; t < threads; t++) workers.emplace_back(work, t);
+        }
+        catch (...) {
+            for (auto& worker : workers) worker.join();
+            throw;
+        }
+        work(0);
+        for (auto& worker : workers) worker.join();
+        if (error) std::rethrow_exception(error);
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::allocate_table(std::size_t buckets, std::size_t threads) {
+        table = alloc.allocate(buckets);
+        flag = state_alloc.allocate(buckets);
+        number_of_buckets = buckets;
+        counter.allocation(2);
+        auto construct = [this](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                std::allocator_traits<Allocator>::construct(alloc, table + i);
+                std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + i);
+            }
+        };
+        // a constructor that cannot throw leaves nothing half built, so only then the pages are touched by several threads
+        if constexpr (std::is_nothrow_default_constructible_v<T1> && std::is_nothrow_default_constructible_v<T2>) {
+            run_threads(threads, [&construct, buckets, threads](std::size_t t) { construct(buckets * t / threads, buckets * (t + 1) / threads); });
+        }
+        else construct(0, buckets);
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    template<typename Element>
+    typename HashMap<T1, T2, Hash, Allocator>::Placement HashMap<T1, T2, Hash, Allocator>::place_in_range(std::size_t index, std::size_t range_end, Element&& element) {
+        // a fresh table has no tombstones, so a bucket is either empty or holds an element
+        for (; index < range_end; index++) {
+            if (flag[index] == BucketState::ABSENT) {
+                table[index] = std::forward<Element>(element);
+                flag[index] = BucketState::PRESENT;
+                return Placement::INSERTED;
+            }
+            if (table[index].first == element.first) {
+                table[index].second = std::forward<Element>(element).second;
+                return Placement::ASSIGNED;
+            }
+        }
+        return Placement::FULL;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    template<typename RandomIt>
+    HashMap<T1, T2, Hash, Allocator> HashMap<T1, T2, Hash, Allocator>::build_parallel(RandomIt first, RandomIt last, unsigned threads, const Hash& _hash, const Allocator& _alloc) {
+        HashMap result(_hash, _alloc);
+        std::size_t n = static_cast<std::size_t>(last - first);
+        std::size_t buckets = result.number_of_buckets;
+        while (static_cast<float>(n) / buckets >= result.REHASHING_COEFFICIENT) buckets *= result.FACTOR_OF_REHASHING;
+        std::size_t workers = std::min<std::size_t>(std::max(1u, threads), std::max<std::size_t>(1, buckets / MIN_PARALLEL_RANGE));
+
+        result.release_table(result.table, result.flag, result.number_of_buckets);
+        result.table = nullptr;
+        result.flag = nullptr;
+        result.number_of_buckets = 0;
+        result.allocate_table(buckets, workers);
+        if (workers == 1) {
+            for (RandomIt cur = first; cur != last; ++cur) result.insert((*cur).first, (*cur).second);
+            return result;
+        }
+
+        // thread r owns the buckets [r * range, (r + 1) * range), so the range of an element is the prefix of its home bucket
+        std::size_t range = (buckets + workers - 1) / workers;
+        std::vector<std::size_t> homes(n);
+        std::vector<std::size_t> counts(workers * workers, 0); // counts[slice * workers + r]: elements of input slice slice that belong to range r
+        run_threads(workers, [&](std::size_t slice) {
+            for (std::size_t i = n * slice / workers; i < n * (slice + 1) / workers; i++) {
+                homes[i] = result.hash((*(first + i)).first) % buckets;
+                counts[slice * workers + homes[i] / range]++;
+            }
+        });
+
+        // order lists the input range by range, each range in input order, so the last of equal keys still wins
+        std::vector<std::size_t> offsets(workers * workers);
+        std::vector<std::size_t> range_start(workers + 1);
+        std::size_t position = 0;
+        for (std::size_t r = 0; r < workers; r++) {
+            range_start[r] = position;
+            for (std::size_t slice = 0; slice < workers; slice++) {
+                offsets[slice * workers + r] = position;
+                position += counts[slice * workers + r];
+            }
+        }
+        range_start[workers] = n;
+        std::vector<std::size_t> order(n);
+        run_threads(workers, [&](std::size_t slice) {
+            std::size_t* next = offsets.data() + slice * workers;
+            for (std::size_t i = n * slice / workers; i < n * (slice + 1) / workers; i++) order[next[homes[i] / range]++] = i;
+        });
+
+        std::vector<std::vector<std::size_t>> overflow(workers);
+        std::vector<std::size_t> inserted(workers, 0);
+        run_threads(workers, [&](std::size_t r) {
+            std::size_t range_end = std::min(buckets, (r + 1) * range);
+            for (std::size_t k = range_start[r]; k < range_start[r + 1]; k++) {
+                std::size_t i = order[k];
+                Placement placement = result.place_in_range(homes[i], range_end, *(first + i));
+                if (placement == Placement::INSERTED) inserted[r]++;
+                else if (placement == Placement::FULL) overflow[r].push_back(i);
+            }
+        });
+        std::size_t overflowed = 0;
+        for (std::size_t r = 0; r < workers; r++) {
+            result.sz += inserted[r];
+            overflowed += overflow[r].size();
+        }
+        result.buckets_used = result.sz;
+        result.counter.copy(n - overflowed);
+
+        // the table stays below the rehashing coefficient, so these inserts only probe into the following ranges
+        for (std::size_t r = 0; r < workers; r++) {
+            for (std::size_t i : overflow[r]) result.insert((*(first + i)).first, (*(first + i)).second);
+        }
+        return result;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::rehash_parallel(unsigned threads) {
+        finish_rehash();
+        std::size_t old_number_of_buckets = number_of_buckets;
+        std::size_t workers = std::min<std::size_t>(std::max(1u, threads), std::max<std::size_t>(1, old_number_of_buckets / MIN_PARALLEL_RANGE));
+        if (workers == 1) {
+            rehash_sequential();
+            return;
+        }
+
+        counter.rehash();
+        std::pair<T1, T2>* old_table = table;
+        BucketState* old_flag = flag;
+        void* old_mapping = mapping;
+        std::size_t old_buckets_used = buckets_used;
+        auto restore = [&] {
+            mapping = old_mapping;
+            table = old_table;
+            flag = old_flag;
+            number_of_buckets = old_number_of_buckets;
+        };
+        mapping = nullptr; // the new table is never mapped
+        try {
+            allocate_table(old_number_of_buckets * FACTOR_OF_REHASHING, workers);
+        }
+        catch (...) {
+            restore();
+            throw;
+        }
+
+        // the table doubles, so an element with the home bucket h gets h or h + old_number_of_buckets:
+        // thread r reads the old range [begin, end) and owns both [begin, end) and [begin, end) + old_number_of_buckets of the new table
+        std::size_t range = (old_number_of_buckets + workers - 1) / workers;
+        std::vector<std::vector<std::size_t>> overflow(workers);
+        std::size_t overflowed = 0;
+        try {
+            run_threads(workers, [&](std::size_t r) {
+                std::size_t begin = std::min(old_number_of_buckets, r * range), end = std::min(old_number_of_buckets, (r + 1) * range);
+                for (std::size_t i = begin; i < end; i++) {
+                    if (old_flag[i] != BucketState::PRESENT) continue;
+                    std::size_t home = hash(old_table[i].first) % number_of_buckets;
+                    std::size_t old_home = home % old_number_of_buckets;
+                    bool placed = false;
+                    // elements displaced from the previous range belong to another thread
+                    if (old_home >= begin && old_home < end) {
+                        std::size_t range_end = home < old_number_of_buckets ? end : end + old_number_of_buckets;
+                        // copied even when the move cannot throw: until the last overflow element is placed hash(), a copy
+                        // or a thread start can still fail, and the old table has to be whole to be restored then
+                        placed = place_in_range(home, range_end, old_table[i]) != Placement::FULL;
+                    }
+                    if (!placed) overflow[r].push_back(i);
+                }
+            });
+            for (auto& positions : overflow) {
+                for (std::size_t i : positions) create_new_table(old_table[i].first, old_table[i].second);
+                overflowed += positions.size();
+            }
+        }
+        catch (...) {
+            // only copies were made, the old table is still whole
+            release_table(table, flag, number_of_buckets);
+            restore();
+            throw;
+        }
+
+        buckets_used = sz;
+        counter.copy(sz - overflowed);
+        mapping = old_mapping;
+        release_table(old_table, old_flag, old_number_of_buckets);
+
+        if (rehash_hook) rehash_hook({ old_number_of_buckets, number_of_buckets, size(), old_buckets_used - sz });
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::insert(const T1& key, const T2& value) {
+        advance_rehash(incremental.step);
+        if (incremental.old_table) {
+            std::size_t old_index = find_old_index(key);
+            if (old_index != incremental.old_number_of_buckets) {
+                incremental.old_table[old_index].second = value;
+                counter.copy();
+                return;
+            }
+        }
+        size_t index = hash(key) % number_of_buckets;
+        while (true) {
+            if (table[index].first == key && flag[index] == BucketState::PRESENT) {
+                table[index].second = value;
+                counter.copy();
+                break;
+            }
+            if (flag[index] == BucketState::ABSENT) {
+                std::allocator_traits<Allocator>::destroy(alloc, table + index);
+                std::allocator_traits<std::allocator<BucketState>>::destroy(state_alloc, flag + index);
+            }
+            if (flag[index] == BucketState::ABSENT) {
+                buckets_used++;
+                std::allocator_traits<Allocator>::construct(alloc, table + index, std::make_pair(key, value));
+                std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + index, BucketState::PRESENT);
+                sz++;
+                counter.copy();
+                break;
+            }
+            else {
+                index++;
+                counter.probe_step();
+                if (index >= number_of_buckets) {
+                    index = 0;
+                }
+            };
+        }
+        if (!rehashing() && static_cast<float>(buckets_used) / number_of_buckets >= REHASHING_COEFFICIENT) {
+            rehash();
+        }
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::insert(std::pair<T1, T2> pair_key_value) { insert(pair_key_value.first, pair_key_value.second); }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::erase(const T1& key) {
+        advance_rehash(incremental.step);
+        std::size_t index = find_index(key);
+        if (index != number_of_buckets) {
+            flag[index] = BucketState::DELETED;
+            sz--;
+        }
+        else if (incremental.old_table) {
+            index = find_old_index(key);
+            if (index != incremental.old_number_of_buckets) {
+                incremental.old_flag[index] = BucketState::DELETED;
+                sz--;
+            }
+        }
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    T2& HashMap<T1, T2, Hash, Allocator>::at(const T1& key) {
+        advance_rehash(incremental.step);
+        if (std::pair<T1, T2>* found = locate(key)) return found->second;
+        insert(key, T2());
+        return locate(key)->second;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::clear() {
+        drop_rehash();
+        release_table(table, flag, number_of_buckets);
+
+        number_of_buckets = DEFAULT_NUMBER_OF_BUCKETS;
+        buckets_used = 0;
+        sz = 0;
+
+        table = alloc.allocate(number_of_buckets);
+        flag = state_alloc.allocate(number_of_buckets);
+        counter.allocation(2);
+        for (std::size_t i = 0; i < number_of_buckets; i++) {
+            std::allocator_traits<Allocator>::construct(alloc, table + i);
+            std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + i);
+        }
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    std::size_t HashMap<T1, T2, Hash, Allocator>::size() const noexcept { return sz; }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    std::size_t HashMap<T1, T2, Hash, Allocator>::bucket_count() const noexcept { return number_of_buckets; }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    bool HashMap<T1, T2, Hash, Allocator>::empty() const noexcept { return size() == 0; }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    int HashMap<T1, T2, Hash, Allocator>::bucket(const T1& key) const noexcept {
+        std::size_t index = find_index(key);
+        return index == number_of_buckets ? -1 : static_cast<int>(index);
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    bool HashMap<T1, T2, Hash, Allocator>::count(const T1& key) const noexcept { return locate(key) != nullptr; }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    std::size_t HashMap<T1, T2, Hash, Allocator>::find_index(const T1& key) const {
+        if (!number_of_buckets) return 0;
+        std::size_t index = hash(key) % number_of_buckets;
+        for (std::size_t probes = 0; probes < number_of_buckets && flag[index] != BucketState::ABSENT; probes++) {
+            if (flag[index] == BucketState::PRESENT && table[index].first == key) return index;
+            index++;
+            counter.probe_step();
+            if (index >= number_of_buckets) {
+                index = 0;
+            }
+        }
+        return number_of_buckets;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    std::size_t HashMap<T1, T2, Hash, Allocator>::find_old_index(const T1& key) const {
+        const IncrementalRehash& r = incremental;
+        // nothing is left before migrated, so probing starts there and wraps around to there
+        std::size_t index = std::max(hash(key) % r.old_number_of_buckets, r.migrated);
+        for (std::size_t probes = r.migrated; probes < r.old_number_of_buckets && r.old_flag[index] != BucketState::ABSENT; probes++) {
+            if (r.old_flag[index] == BucketState::PRESENT && r.old_table[index].first == key) return index;
+            index++;
+            counter.probe_step();
+            if (index >= r.old_number_of_buckets) {
+                index = r.migrated;
+            }
+        }
+        return r.old_number_of_buckets;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    std::pair<T1, T2>* HashMap<T1, T2, Hash, Allocator>::locate(const T1& key) const {
+        std::size_t index = find_index(key);
+        if (index != number_of_buckets) return table + index;
+        if (incremental.old_table) {
+            index = find_old_index(key);
+            if (index != incremental.old_number_of_buckets) return incremental.old_table + index;
+        }
+        return nullptr;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    T2* HashMap<T1, T2, Hash, Allocator>::find(const T1& key) {
+        advance_rehash(incremental.step);
+        std::pair<T1, T2>* found = locate(key);
+        return found ? &found->second : nullptr;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    const T2* HashMap<T1, T2, Hash, Allocator>::find(const T1& key) const {
+        std::pair<T1, T2>* found = locate(key);
+        return found ? &found->second : nullptr;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    template<typename Function>
+    void HashMap<T1, T2, Hash, Allocator>::for_each(Function f) const {
+        for (std::size_t i = 0; i < number_of_buckets; i++) {
+            if (flag[i] == BucketState::PRESENT) f(table[i].first, table[i].second);
+        }
+        for (std::size_t i = incremental.migrated; i < incremental.old_number_of_buckets; i++) {
+            if (incremental.old_flag[i] == BucketState::PRESENT) f(incremental.old_table[i].first, incremental.old_table[i].second);
+        }
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    HashStats HashMap<T1, T2, Hash, Allocator>::stats() const {
+        return HashStatsDetail::collect_hash_stats(number_of_buckets,
+            [this](std::size_t i) { return static_cast<int>(flag[i]); },
+            [this](std::size_t i) { return hash(table[i].first) % number_of_buckets; });
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::set_rehash_hook(RehashHook hook) { rehash_hook = std::move(hook); }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    std::size_t HashMap<T1, T2, Hash, Allocator>::next_present(std::size_t index) const noexcept {
+        while (index < number_of_buckets && flag[index] != BucketState::PRESENT) index++;
+        if (index < number_of_buckets || !incremental.old_table) return index;
+        std::size_t old_index = std::max(index - number_of_buckets, incremental.migrated);
+        while (old_index < incremental.old_number_of_buckets && incremental.old_flag[old_index] != BucketState::PRESENT) old_index++;
+        return number_of_buckets + old_index;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    bool HashMap<T1, T2, Hash, Allocator>::present(std::size_t index) const noexcept {
+        if (index < number_of_buckets) return flag[index] == BucketState::PRESENT;
+        return incremental.old_flag[index - number_of_buckets] == BucketState::PRESENT;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    std::pair<T1, T2>& HashMap<T1, T2, Hash, Allocator>::element(std::size_t index) const noexcept {
+        return index < number_of_buckets ? table[index] : incremental.old_table[index - number_of_buckets];
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::release_table(std::pair<T1, T2>* old_table, BucketState* old_flag, std::size_t old_number_of_buckets, std::size_t destroyed) {
+        // a mapped snapshot is the only table the map has, so it is the one released
+        if (mapping) {
+#if defined(__unix__) || defined(__APPLE__)
+            ::munmap(mapping, mapping_length);
+#endif
+            mapping = nullptr;
+            mapping_length = 0;
+            return;
+        }
+        // the states are trivially destructible, so a table of trivial elements is only deallocated
+        if constexpr (!std::is_trivially_destructible_v<std::pair<T1, T2>>) {
+            for (std::size_t i = destroyed; i < old_number_of_buckets; i++) std::allocator_traits<Allocator>::destroy(alloc, old_table + i);
+        }
+        alloc.deallocate(old_table, old_number_of_buckets);
+        state_alloc.deallocate(old_flag, old_number_of_buckets);
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    std::uint64_t HashMap<T1, T2, Hash, Allocator>::hash_check() const {
+        std::uint64_t check = number_of_buckets;
+        std::size_t keys = 0;
+        for (std::size_t i = next_present(0); i < number_of_buckets && keys < 8; i = next_present(i + 1), keys++) {
+            check = (check ^ static_cast<std::uint64_t>(hash(table[i].first))) * 0x100000001B3ull;
+        }
+        return check;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    typename HashMap<T1, T2, Hash, Allocator>::SnapshotHeader HashMap<T1, T2, Hash, Allocator>::snapshot_header() const {
+        // both arrays start on a cache line, or on the alignment of the element if it is larger
+        const std::uint64_t alignment = std::max<std::uint64_t>(64, alignof(std::pair<T1, T2>));
+        auto align = [alignment](std::uint64_t offset) { return (offset + alignment - 1) / alignment * alignment; };
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, "MYHMAP\0", sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        header.byte_order = 0x01020304;
+        header.key_size = sizeof(T1);
+        header.value_size = sizeof(T2);
+        header.entry_size = sizeof(std::pair<T1, T2>);
+        header.entry_alignment = alignof(std::pair<T1, T2>);
+        header.state_size = sizeof(BucketState);
+        header.number_of_buckets = number_of_buckets;
+        header.size = sz;
+        header.buckets_used = buckets_used;
+        header.hash_check = hash_check();
+        header.table_offset = align(sizeof(SnapshotHeader));
+        header.flag_offset = align(header.table_offset + number_of_buckets * sizeof(std::pair<T1, T2>));
+        header.file_size = header.flag_offset + number_of_buckets * sizeof(BucketState);
+        return header;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    bool HashMap<T1, T2, Hash, Allocator>::valid_snapshot(const SnapshotHeader& header, std::uint64_t file_size) {
+        return std::memcmp(header.magic, "MYHMAP\0", sizeof(header.magic)) == 0
+            && header.version == SNAPSHOT_VERSION
+            && header.byte_order == 0x01020304
+            && header.key_size == sizeof(T1)
+            && header.value_size == sizeof(T2)
+            && header.entry_size == sizeof(std::pair<T1, T2>)
+            && header.entry_alignment == alignof(std::pair<T1, T2>)
+            && header.state_size == sizeof(BucketState)
+            && header.number_of_buckets > 0
+            && header.size <= header.buckets_used && header.buckets_used < header.number_of_buckets
+            && header.table_offset % alignof(std::pair<T1, T2>) == 0
+            && header.table_offset >= sizeof(SnapshotHeader)
+            // the sizes of the arrays are compared by division, a product of a forged bucket count could wrap around
+            && header.file_size <= file_size
+            && header.table_offset <= header.flag_offset && header.flag_offset <= header.file_size
+            && header.number_of_buckets <= (header.flag_offset - header.table_offset) / header.entry_size
+            && header.number_of_buckets <= (header.file_size - header.flag_offset) / header.state_size
+            && header.file_size - header.flag_offset == header.number_of_buckets * header.state_size;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::save(const std::string& path) const {
+        static_assert(std::is_trivially_copyable_v<T1> && std::is_trivially_copyable_v<T2>, "HashMap::save() needs trivially copyable keys and values.");
+        if (!number_of_buckets) throw std::logic_error("Cannot save a moved-from HashMap."); // EXCEPTION
+        if (incremental.old_table) throw std::logic_error("Cannot save a HashMap while it is migrating, call finish_rehash() first."); // EXCEPTION
+
+        SnapshotHeader header = snapshot_header();
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) throw std::runtime_error("Cannot open " + path + " for writing."); // EXCEPTION
+
+        const std::string padding(header.flag_offset, '\0');
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(padding.data(), header.table_offset - sizeof(header));
+        out.write(reinterpret_cast<const char*>(table), number_of_buckets * sizeof(std::pair<T1, T2>));
+        out.write(padding.data(), header.flag_offset - header.table_offset - number_of_buckets * sizeof(std::pair<T1, T2>));
+        out.write(reinterpret_cast<const char*>(flag), number_of_buckets * sizeof(BucketState));
+        out.flush();
+        if (!out) throw std::runtime_error("Cannot write " + path + "."); // EXCEPTION
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    HashMap<T1, T2, Hash, Allocator> HashMap<T1, T2, Hash, Allocator>::open_mapped(const std::string& path, const Hash& _hash, const Allocator& _alloc) {
+        static_assert(std::is_trivially_copyable_v<T1> && std::is_trivially_copyable_v<T2>, "HashMap::open_mapped() needs trivially copyable keys and values.");
+        HashMap result(_hash, _alloc);
+        SnapshotHeader header;
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open " + path + "."); // EXCEPTION
+        struct stat file_stat;
+        if (::fstat(fd, &file_stat) != 0 || static_cast<std::uint64_t>(file_stat.st_size) < sizeof(SnapshotHeader)) {
+            ::close(fd);
+            throw std::runtime_error(path + " is not a HashMap snapshot."); // EXCEPTION
+        }
+        std::size_t length = static_cast<std::size_t>(file_stat.st_size);
+        // private and writable: the map can be changed, the touched pages are copied and the file stays as it is
+        void* mapped = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) throw std::runtime_error("Cannot map " + path + "."); // EXCEPTION
+        std::memcpy(&header, mapped, sizeof(header));
+        if (!valid_snapshot(header, length)) {
+            ::munmap(mapped, length);
+            throw std::runtime_error(path + " is not a HashMap snapshot of this key and value type."); // EXCEPTION
+        }
+        ::madvise(mapped, length, MADV_RANDOM); // lookups touch one or two pages each, read-ahead would be wasted
+
+        result.release_table(result.table, result.flag, result.number_of_buckets);
+        result.mapping = mapped;
+        result.mapping_length = length;
+        result.table = reinterpret_cast<std::pair<T1, T2>*>(static_cast<char*>(mapped) + header.table_offset);
+        result.flag = reinterpret_cast<BucketState*>(static_cast<char*>(mapped) + header.flag_offset);
+#else
+        // without mmap the arrays are read into freshly allocated memory, still without visiting the elements
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) throw std::runtime_error("Cannot open " + path + "."); // EXCEPTION
+        std::uint64_t length = static_cast<std::uint64_t>(in.tellg());
+        in.seekg(0);
+        if (length < sizeof(SnapshotHeader) || !in.read(reinterpret_cast<char*>(&header), sizeof(header)) || !valid_snapshot(header, length)) {
+            throw std::runtime_error(path + " is not a HashMap snapshot of this key and value type."); // EXCEPTION
+        }
+        result.release_table(result.table, result.flag, result.number_of_buckets);
+        result.table = result.alloc.allocate(header.number_of_buckets);
+        result.flag = result.state_alloc.allocate(header.number_of_buckets);
+        result.counter.allocation(2);
+        in.seekg(header.table_offset);
+        in.read(reinterpret_cast<char*>(result.table), header.number_of_buckets * sizeof(std::pair<T1, T2>));
+        in.seekg(header.flag_offset);
+        in.read(reinterpret_cast<char*>(result.flag), header.number_of_buckets * sizeof(BucketState));
+        result.number_of_buckets = header.number_of_buckets;
+        if (!in) throw std::runtime_error("Cannot read " + path + "."); // EXCEPTION
+#endif
+        result.number_of_buckets = header.number_of_buckets;
+        result.buckets_used = header.buckets_used;
+        result.sz = header.size;
+        // the table is only usable with the hash function it was built with
+        if (result.hash_check() != header.hash_check) throw std::runtime_error(path + " was saved with a different hash function."); // EXCEPTION
+        return result;
+    }
+
+    template<typename T1, typename T2, typename Hash, typename Allocator>
+    void HashMap<T1, T2, Hash, Allocator>::display() const {
+        for (std::size_t i = 0; i < number_of_buckets; i++) {
+            std::cout << i << ": key: " << table[i].first << "; value: " << table[i].second << "; flag: " << static_cast<int>(flag[i]) << std::endl;
+        }
+    }
+}
+
+#endif // !__HASHMAP_HPP__
\ No newline at end of file
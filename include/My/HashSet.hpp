@@ -1,8 +1,12 @@
-﻿#include "Vector.hpp" // I use My::Vector to implement iterators
+﻿#pragma once
+#ifndef __HASHSET_HPP__
+#define __HASHSET_HPP__
+
+#include "Vector.hpp" // I use My::Vector to implement iterators
+#include "HashStats.hpp"
+#include "Counters.hpp"
 #include <algorithm>
-#include <string>
 #include <functional>
-#include "TestHashAndAllocator.hpp"
 
 namespace My {
     template <typename T, typename Hash = std::hash<T>, typename Allocator = std::allocator<T>>
@@ -22,6 +26,8 @@ namespace My {
 
         std::size_t number_of_buckets;
         std::size_t buckets_used;
+        RehashHook rehash_hook;
+        [[no_unique_address]] InstanceCounters counter;
 
         void rehash();
         void create_new_table(const T& key);
@@ -48,6 +54,10 @@ namespace My {
         bool empty() const noexcept;
         int bucket(const T& key) const noexcept;
         bool count(const T& key) const noexcept;
+        HashStats stats() const; // probe lengths, tombstones and clustering, O(bucket_count)
+        Counters counters() const noexcept; // zeros unless MY_CONTAINERS_STATS is defined, includes the allocations and copies of iter_vec
+        void reset_counters() noexcept;
+        void set_rehash_hook(RehashHook hook); // called after every rehash, an empty function removes the hook
         void display() const; // additional method to display hash-table and bucket status, this works only with primitive data types
 
         class iterator {
@@ -76,6 +86,7 @@ namespace My {
 
         table = alloc.allocate(number_of_buckets);
         flag = state_alloc.allocate(number_of_buckets);
+        counter.allocation(2);
         for (std::size_t i = 0; i < number_of_buckets; i++) {
             std::allocator_traits<Allocator>::construct(alloc, table + i);
             std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + i);
@@ -90,6 +101,7 @@ namespace My {
 
         table = alloc.allocate(number_of_buckets);
         flag = state_alloc.allocate(number_of_buckets);
+        counter.allocation(2);
         for (std::size_t i = 0; i < number_of_buckets; i++) {
             std::allocator_traits<Allocator>::construct(alloc, table + i);
             std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + i);
@@ -110,9 +122,12 @@ namespace My {
         hash = other.hash;
         alloc = other.alloc;
         iter_vec = other.iter_vec;
+        rehash_hook = other.rehash_hook;
         if (other.table && other.flag) {
             table = alloc.allocate(number_of_buckets);
             flag = state_alloc.allocate(number_of_buckets);
+            counter.allocation(2);
+            counter.copy(number_of_buckets);
             for (std::size_t i = 0; i < number_of_buckets; i++) {
                 std::allocator_traits<Allocator>::construct(alloc, table + i, other.table[i]);
                 std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + i, other.flag[i]);
@@ -133,6 +148,7 @@ namespace My {
         hash = std::move(other.hash);
         alloc = std::move(other.alloc);
         iter_vec = std::move(other.iter_vec);
+        rehash_hook = std::move(other.rehash_hook);
 
         other.number_of_buckets = 0;
         other.buckets_used = 0;
@@ -165,9 +181,12 @@ namespace My {
             hash = other.hash;
             alloc = other.alloc;
             iter_vec = other.iter_vec;
+            rehash_hook = other.rehash_hook;
             if (other.table && other.flag) {
                 table = alloc.allocate(number_of_buckets);
                 flag = state_alloc.allocate(number_of_buckets);
+                counter.allocation(2);
+                counter.copy(number_of_buckets);
                 for (std::size_t i = 0; i < number_of_buckets; i++)
                 {
                     std::allocator_traits<Allocator>::construct(alloc, table + i, other.table[i]);
@@ -199,6 +218,7 @@ namespace My {
             hash = std::move(other.hash);
             alloc = std::move(other.alloc);
             iter_vec = std::move(other.iter_vec);
+            rehash_hook = std::move(other.rehash_hook);
 
             other.number_of_buckets = 0;
             other.buckets_used = 0;
@@ -210,13 +230,16 @@ namespace My {
 
     template <typename T, typename Hash, typename Allocator>
     void HashSet<T, Hash, Allocator>::rehash() {
+        counter.rehash();
         T* copy_of_table = std::move(table);
         BucketState* copy_of_flag = std::move(flag);
         std::size_t old_number_of_buckets = number_of_buckets;
         number_of_buckets = number_of_buckets * FACTOR_OF_REHASHING;
+        std::size_t tombstones_dropped = 0;
 
         table = alloc.allocate(number_of_buckets);
         flag = state_alloc.allocate(number_of_buckets);
+        counter.allocation(2);
         for (std::size_t i = 0; i < number_of_buckets; i++) {
             std::allocator_traits<Allocator>::construct(alloc, table + i);
             std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + i);
@@ -227,6 +250,7 @@ namespace My {
                 std::allocator_traits<Allocator>::destroy(alloc, copy_of_flag + i);
                 std::allocator_traits<std::allocator<BucketState>>::destroy(state_alloc, copy_of_flag + i);
                 buckets_used--;
+                tombstones_dropped++;
             }
             if (copy_of_flag[i] == BucketState::DELETED) {
                 std::allocator_traits<Allocator>::construct(alloc, copy_of_flag + i);
@@ -242,6 +266,8 @@ namespace My {
         }
         alloc.deallocate(copy_of_table, old_number_of_buckets);
         state_alloc.deallocate(copy_of_flag, old_number_of_buckets);
+
+        if (rehash_hook) rehash_hook({ old_number_of_buckets, number_of_buckets, size(), tombstones_dropped });
     }
 
     template<typename T, typename Hash, typename Allocator>
@@ -255,10 +281,12 @@ namespace My {
             if (flag[index] == BucketState::ABSENT) {
                 std::allocator_traits<Allocator>::construct(alloc, table + index, key);
                 std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + index, BucketState::PRESENT);
+                counter.copy();
                 break;
             }
             else {
                 index++;
+                counter.probe_step();
                 if (index >= number_of_buckets) {
                     index = 0;
                 }
@@ -282,10 +310,12 @@ namespace My {
                 std::allocator_traits<Allocator>::construct(alloc, table + index, key);
                 std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + index, BucketState::PRESENT);
                 iter_vec.push_back(key);
+                counter.copy();
                 break;
             }
             else {
                 index++;
+                counter.probe_step();
                 if (index >= number_of_buckets) {
                     index = 0;
                 }
@@ -302,6 +332,7 @@ namespace My {
         if (table[index] != key) {
             do {
                 index++;
+                counter.probe_step();
                 if (index >= number_of_buckets) {
                     index = 0;
                 }
@@ -329,6 +360,7 @@ namespace My {
 
         table = alloc.allocate(number_of_buckets);
         flag = state_alloc.allocate(number_of_buckets);
+        counter.allocation(2);
         for (std::size_t i = 0; i < number_of_buckets; i++) {
             std::allocator_traits<Allocator>::construct(alloc, table + i);
             std::allocator_traits<std::allocator<BucketState>>::construct(state_alloc, flag + i);
@@ -361,83 +393,38 @@ namespace My {
     }
 
     template<typename T, typename Hash, typename Allocator>
-    void HashSet<T, Hash, Allocator>::display() const {
-        for (std::size_t i = 0; i < number_of_buckets; i++) {
-            std::cout << i << ": key: " << table[i] << "; flag: " << static_cast<int>(flag[i]) << std::endl;
-        }
+    HashStats HashSet<T, Hash, Allocator>::stats() const {
+        return HashStatsDetail::collect_hash_stats(number_of_buckets,
+            [this](std::size_t i) { return static_cast<int>(flag[i]); },
+            [this](std::size_t i) { return hash(table[i]) % number_of_buckets; });
     }
-}
 
-int main() {
-    using namespace My;
-
-    std::cout << "My::HashSet\n";
-
-    HashSet<int> A;
-    A.insert(1);
-    A.erase(1);
-    A.insert(2);
-    A.erase(2);
-    A.insert(3);
-    A.insert(4);
-    A.insert(5);
- 
-    for (auto& i : A)
-    {
-        std::cout << i << " ";
-    }
-    std::cout << "\n";
-
-    std::cout << "A.size(): " << A.size() << "\nA.bucket_count(): " << A.bucket_count() << "\n";
-
-    HashSet<int> B = A;
-
-    A = B;
-
-    for (HashSet<int>::iterator it = B.begin(); it != B.end(); it++)
-    {
-        std::cout << *it << " ";
+    template<typename T, typename Hash, typename Allocator>
+    Counters HashSet<T, Hash, Allocator>::counters() const noexcept {
+        Counters result = counter.get();
+        Counters vector_counters = iter_vec.counters();
+        result.allocations += vector_counters.allocations;
+        result.reallocations += vector_counters.reallocations;
+        result.copies += vector_counters.copies;
+        result.moves += vector_counters.moves;
+        return result;
     }
-    std::cout << "\n";
-
-    B.insert(9);
-    B.insert(53);
-    B.insert(979);
-    B.insert(32);
-
-    A = std::move(B);
 
-    for (auto& i : A)
-    {
-        std::cout << i << " ";
+    template<typename T, typename Hash, typename Allocator>
+    void HashSet<T, Hash, Allocator>::reset_counters() noexcept {
+        counter.reset();
+        iter_vec.reset_counters();
     }
-    std::cout << "\n";
-
-    A.clear();
-    std::cout << A.empty() << "\n\n";
 
-    std::cout << "initializer_list\n";
-
-    HashSet<std::string> E{"Apple", "Banana", "Cucumber", "Frog", "Set", "31314", " ", "ABCDE"};
-    E.erase("31314");
+    template<typename T, typename Hash, typename Allocator>
+    void HashSet<T, Hash, Allocator>::set_rehash_hook(RehashHook hook) { rehash_hook = std::move(hook); }
 
-    for (auto& i : E)
-    {
-        std::cout << i << " ";
+    template<typename T, typename Hash, typename Allocator>
+    void HashSet<T, Hash, Allocator>::display() const {
+        for (std::size_t i = 0; i < number_of_buckets; i++) {
+            std::cout << i << ": key: " << table[i] << "; flag: " << static_cast<int>(flag[i]) << std::endl;
+        }
     }
-    std::cout << "\n";
-
-    std::cout << E.size() << "\n\n";
-
-    std::cout << "custom hash function + custom allocator\n";
-
-    HashSet <int, Test::Hash<int>, Test::Allocator<int>> G;
-
-    G.insert(1);
-    G.insert(20);
-    G.erase(20);
-
-    G.display();
+}
 
-    return 0;
-}
\ No newline at end of file
+#endif // !__HASHSET_HPP__
\ No newline at end of file
@@ -0,0 +1,81 @@
+﻿#pragma once
+#ifndef __HASH_STATS_HPP__
+#define __HASH_STATS_HPP__
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+// Introspection of the open addressing tables of My::HashMap and My::HashSet
+namespace My {
+    // a snapshot of the table returned by stats(), one pass over the buckets and one hash per element
+    struct HashStats {
+        std::size_t size = 0;
+        std::size_t bucket_count = 0;
+        std::size_t tombstones = 0; // erased buckets that still lengthen the probes until the next rehash
+        float load_factor = 0; // size / bucket_count
+        float occupancy = 0; // (size + tombstones) / bucket_count, the value compared with the rehashing coefficient
+        double average_probe_length = 0; // buckets read by a successful lookup, 1 means the element is in its home bucket
+        std::size_t max_probe_length = 0;
+        std::vector<std::size_t> probe_histogram; // probe_histogram[i] elements need i + 1 probes
+        std::size_t longest_cluster = 0; // the longest run of occupied or erased buckets, a missing key may probe all of it
+    };
+
+    // passed to the rehash hook after the table has grown
+    struct RehashEvent {
+        std::size_t old_bucket_count;
+        std::size_t new_bucket_count;
+        std::size_t size;
+        std::size_t tombstones_dropped;
+    };
+
+    using RehashHook = std::function<void(const RehashEvent&)>;
+
+    namespace HashStatsDetail {
+        // state(i) is 0 for an empty bucket, 1 for an element and 2 for a tombstone, home(i) is the bucket the element of i hashes to
+        template<typename State, typename Home>
+        HashStats collect_hash_stats(std::size_t bucket_count, State state, Home home) {
+            HashStats stats;
+            stats.bucket_count = bucket_count;
+            if (!bucket_count) return stats;
+
+            double total_probes = 0;
+            std::size_t first_empty = bucket_count;
+            for (std::size_t i = 0; i < bucket_count; i++) {
+                int s = state(i);
+                if (s == 0) {
+                    if (first_empty == bucket_count) first_empty = i;
+                    continue;
+                }
+                if (s == 2) {
+                    stats.tombstones++;
+                    continue;
+                }
+                std::size_t distance = (i + bucket_count - home(i)) % bucket_count;
+                if (distance >= stats.probe_histogram.size()) stats.probe_histogram.resize(distance + 1);
+                stats.probe_histogram[distance]++;
+                total_probes += distance + 1;
+                stats.size++;
+            }
+            stats.max_probe_length = stats.probe_histogram.size();
+            if (stats.size) stats.average_probe_length = total_probes / stats.size;
+            stats.load_factor = static_cast<float>(stats.size) / bucket_count;
+            stats.occupancy = static_cast<float>(stats.size + stats.tombstones) / bucket_count;
+
+            // clusters wrap around the end of the table, so the walk starts right after an empty bucket
+            if (first_empty == bucket_count) {
+                stats.longest_cluster = bucket_count;
+                return stats;
+            }
+            std::size_t run = 0;
+            for (std::size_t step = 1; step <= bucket_count; step++) {
+                std::size_t i = (first_empty + step) % bucket_count;
+                if (state(i) == 0) run = 0;
+                else if (++run > stats.longest_cluster) stats.longest_cluster = run;
+            }
+            return stats;
+        }
+    }
+}
+
+#endif // !__HASH_STATS_HPP__
\ No newline at end of file
@@ -0,0 +1,619 @@
+﻿#pragma once
+#ifndef __INTRUSIVE_HPP__
+#define __INTRUSIVE_HPP__
+
+#include <utility>
+#include <stdexcept>
+#include <iterator>
+#include <type_traits>
+#include <compare>
+#include <functional>
+#include <cstddef>
+#include "Compare.hpp"
+
+// Intrusive containers keep their links in a hook member of the user type, so insert and erase never allocate
+// and one object can be in several containers at once through several hooks.
+// The containers never own their elements: an element must stay alive and must not move while it is linked.
+// A hook is named by a member pointer of its own hook type and keeps a pointer to its owner while it is linked,
+// so the containers get from a hook back to the element without any offset arithmetic and T can be any class.
+namespace My {
+    struct ListHook {
+        ListHook* next = nullptr;
+        ListHook* prev = nullptr;
+        void* owner = nullptr; // the element, set when it is linked
+
+        ListHook() = default;
+        ListHook(const ListHook&) noexcept {} // a copied object starts unlinked
+        ListHook& operator=(const ListHook&) noexcept { return *this; }
+        bool is_linked() const noexcept { return next != nullptr; }
+    };
+
+    struct MapHook {
+        enum class Color { BLACK, RED };
+
+        MapHook* left = nullptr;
+        MapHook* right = nullptr;
+        MapHook* parent = nullptr;
+        Color color = Color::BLACK;
+        void* owner = nullptr; // the element while it is linked, nullptr otherwise
+
+        MapHook() = default;
+        MapHook(const MapHook&) noexcept {}
+        MapHook& operator=(const MapHook&) noexcept { return *this; }
+        bool is_linked() const noexcept { return owner != nullptr; }
+    };
+
+    // doubly linked list through the ListHook member Hook of T
+    template <typename T, ListHook T::* Hook>
+    class IntrusiveList {
+        ListHook sentinel; // circular list, end() points to sentinel
+        std::size_t sz;
+
+        static T& owner(ListHook* hook) noexcept { return *static_cast<T*>(hook->owner); }
+        static ListHook* hook_of(T& value) noexcept { return &(value.*Hook); }
+        static void link_before(ListHook* position, ListHook* hook) noexcept;
+        static void unlink(ListHook* hook) noexcept;
+        void take_links(IntrusiveList& other) noexcept;
+
+    public:
+        class iterator {
+            ListHook* ptr;
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            friend class IntrusiveList;
+            iterator() = default;
+            iterator(ListHook* _ptr) : ptr(_ptr) {}
+            iterator& operator++() { ptr = ptr->next; return *this; }
+            iterator operator++(int) { iterator tmp = *this; ptr = ptr->next; return tmp; }
+            iterator& operator--() { ptr = ptr->prev; return *this; }
+            iterator operator--(int) { iterator tmp = *this; ptr = ptr->prev; return tmp; }
+            bool operator==(const iterator& other) const noexcept { return ptr == other.ptr; }
+            bool operator!=(const iterator& other) const noexcept { return !(*this == other); }
+            T& operator*() const noexcept { return owner(ptr); }
+            T* operator->() const noexcept { return &owner(ptr); }
+        };
+
+        IntrusiveList() noexcept;
+        IntrusiveList(const IntrusiveList&) = delete;
+        IntrusiveList(IntrusiveList&& other) noexcept;
+
+        ~IntrusiveList() { clear(); }
+
+        IntrusiveList& operator= (const IntrusiveList&) = delete;
+        IntrusiveList& operator= (IntrusiveList&& other) noexcept;
+
+        iterator insert(iterator position, T& value);
+        iterator erase(iterator position);
+        void erase(T& value); // O(1), value must be linked into this list
+        void push_back(T& value) { insert(end(), value); }
+        void push_front(T& value) { insert(begin(), value); }
+        void pop_back();
+        void pop_front();
+        void splice(iterator position, IntrusiveList& other) noexcept; // O(1)
+        void splice(iterator position, T& value) noexcept; // O(1), moves value that is linked into this list
+        void clear() noexcept; // unlinks every element
+        T& front() const noexcept { return owner(sentinel.next); }
+        T& back() const noexcept { return owner(sentinel.prev); }
+        std::size_t size() const noexcept { return sz; }
+        bool empty() const noexcept { return sz == 0; }
+
+        iterator iterator_to(T& value) noexcept { return iterator(hook_of(value)); }
+        iterator begin() { return iterator(sentinel.next); };
+        iterator end() { return iterator(&sentinel); };
+    };
+
+    template<typename T, ListHook T::* Hook>
+    void IntrusiveList<T, Hook>::link_before(ListHook* position, ListHook* hook) noexcept {
+        hook->next = position;
+        hook->prev = position->prev;
+        position->prev->next = hook;
+        position->prev = hook;
+    }
+
+    template<typename T, ListHook T::* Hook>
+    void IntrusiveList<T, Hook>::unlink(ListHook* hook) noexcept {
+        hook->prev->next = hook->next;
+        hook->next->prev = hook->prev;
+        hook->next = hook->prev = nullptr;
+    }
+
+    template<typename T, ListHook T::* Hook>
+    void IntrusiveList<T, Hook>::take_links(IntrusiveList& other) noexcept {
+        sz = other.sz;
+        if (other.sz == 0) sentinel.next = sentinel.prev = &sentinel;
+        else {
+            sentinel.next = other.sentinel.next;
+            sentinel.prev = other.sentinel.prev;
+            sentinel.next->prev = &sentinel;
+            sentinel.prev->next = &sentinel;
+        }
+        other.sentinel.next = other.sentinel.prev = &other.sentinel;
+        other.sz = 0;
+    }
+
+    template<typename T, ListHook T::* Hook>
+    IntrusiveList<T, Hook>::IntrusiveList() noexcept : sz(0) { sentinel.next = sentinel.prev = &sentinel; }
+
+    template<typename T, ListHook T::* Hook>
+    IntrusiveList<T, Hook>::IntrusiveList(IntrusiveList&& other) noexcept { take_links(other); }
+
+    template<typename T, ListHook T::* Hook>
+    IntrusiveList<T, Hook>& IntrusiveList<T, Hook>::operator=(IntrusiveList&& other) noexcept {
+        if (this != &other) {
+            clear();
+            take_links(other);
+        }
+        return *this;
+    }
+
+    template<typename T, ListHook T::* Hook>
+    typename IntrusiveList<T, Hook>::iterator IntrusiveList<T, Hook>::insert(iterator position, T& value) {
+        ListHook* hook = hook_of(value);
+        if (hook->is_linked()) throw std::invalid_argument("intrusive list insert of a linked value."); // EXCEPTION
+        hook->owner = &value;
+        link_before(position.ptr, hook);
+        sz++;
+        return iterator(hook);
+    }
+
+    template<typename T, ListHook T::* Hook>
+    typename IntrusiveList<T, Hook>::iterator IntrusiveList<T, Hook>::erase(iterator position) {
+        if (sz == 0 || position.ptr == &sentinel) throw std::out_of_range("intrusive list erase iterator outside range."); // EXCEPTION
+        iterator next(position.ptr->next);
+        unlink(position.ptr);
+        sz--;
+        return next;
+    }
+
+    template<typename T, ListHook T::* Hook>
+    void IntrusiveList<T, Hook>::erase(T& value) {
+        ListHook* hook = hook_of(value);
+        if (!hook->is_linked()) throw std::out_of_range("intrusive list erase of an unlinked value."); // EXCEPTION
+        unlink(hook);
+        sz--;
+    }
+
+    template<typename T, ListHook T::* Hook>
+    void IntrusiveList<T, Hook>::pop_back() {
+        if (!sz) throw std::out_of_range("pop_back called on empty intrusive list."); // EXCEPTION
+        unlink(sentinel.prev);
+        sz--;
+    }
+
+    template<typename T, ListHook T::* Hook>
+    void IntrusiveList<T, Hook>::pop_front() {
+        if (!sz) throw std::out_of_range("pop_front called on empty intrusive list."); // EXCEPTION
+        unlink(sentinel.next);
+        sz--;
+    }
+
+    template<typename T, ListHook T::* Hook>
+    void IntrusiveList<T, Hook>::splice(iterator position, IntrusiveList& other) noexcept {
+        if (this == &other || other.sz == 0) return;
+
+        ListHook* first = other.sentinel.next;
+        ListHook* last = other.sentinel.prev;
+        first->prev = position.ptr->prev;
+        last->next = position.ptr;
+        position.ptr->prev->next = first;
+        position.ptr->prev = last;
+
+        sz += other.sz;
+        other.sentinel.next = other.sentinel.prev = &other.sentinel;
+        other.sz = 0;
+    }
+
+    template<typename T, ListHook T::* Hook>
+    void IntrusiveList<T, Hook>::splice(iterator position, T& value) noexcept {
+        ListHook* hook = hook_of(value);
+        if (position.ptr == hook || position.ptr == hook->next) return;
+        hook->prev->next = hook->next;
+        hook->next->prev = hook->prev;
+        link_before(position.ptr, hook);
+    }
+
+    template<typename T, ListHook T::* Hook>
+    void IntrusiveList<T, Hook>::clear() noexcept {
+        ListHook* cur = sentinel.next;
+        while (cur != &sentinel) {
+            ListHook* forward = cur->next;
+            cur->next = cur->prev = nullptr;
+            cur = forward;
+        }
+        sentinel.next = sentinel.prev = &sentinel;
+        sz = 0;
+    }
+
+    // ordered index by the key member KeyMember of T through the MapHook member Hook of T, keys are unique like in My::Map
+    // Compare is either a three-way comparator or a less-style comparator returning bool
+    template <typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare = DefaultCompare>
+    class IntrusiveMap {
+        using Color = MapHook::Color;
+
+        MapHook* root;
+        std::size_t sz;
+        Compare comp;
+
+        static T& owner(MapHook* hook) noexcept { return *static_cast<T*>(hook->owner); }
+        static MapHook* hook_of(T& value) noexcept { return &(value.*Hook); }
+        static const Key& key_of(MapHook* hook) noexcept { return owner(hook).*KeyMember; }
+        static MapHook* leftmost(MapHook* cur) noexcept;
+        static MapHook* rightmost(MapHook* cur) noexcept;
+        static MapHook* successor(MapHook* cur) noexcept;
+        static MapHook* predecessor(MapHook* cur) noexcept;
+        static Color color_of(const MapHook* cur) noexcept { return cur ? cur->color : Color::BLACK; }
+        int compare(const Key& lhs, const Key& rhs) const;
+        void left_rotation(MapHook* cur) noexcept;
+        void right_rotation(MapHook* cur) noexcept;
+        void replace_child(MapHook* parent, MapHook* old_child, MapHook* new_child) noexcept;
+        void balancing_after_insert(MapHook* cur) noexcept;
+        void balancing_after_erase(MapHook* cur, MapHook* parent) noexcept;
+        void unlink(MapHook* hook) noexcept;
+
+    public:
+        class iterator {
+            MapHook* ptr;
+            IntrusiveMap* this_map;
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            friend class IntrusiveMap;
+            iterator() = default;
+            iterator(MapHook* _ptr, IntrusiveMap* _this_map) : ptr(_ptr), this_map(_this_map) {}
+            iterator& operator++() { ptr = successor(ptr); return *this; }
+            iterator operator++(int) { iterator tmp = *this; ++*this; return tmp; }
+            iterator& operator--() { ptr = ptr ? predecessor(ptr) : rightmost(this_map->root); return *this; }
+            iterator operator--(int) { iterator tmp = *this; --*this; return tmp; }
+            bool operator==(const iterator& other) const noexcept { return ptr == other.ptr; }
+            bool operator!=(const iterator& other) const noexcept { return !(*this == other); }
+            T& operator*() const noexcept { return owner(ptr); }
+            T* operator->() const noexcept { return &owner(ptr); }
+        };
+
+        IntrusiveMap(const Compare& _comp = Compare()) : root(nullptr), sz(0), comp(_comp) {}
+        IntrusiveMap(const IntrusiveMap&) = delete;
+        IntrusiveMap(IntrusiveMap&& other) noexcept;
+
+        ~IntrusiveMap() { clear(); }
+
+        IntrusiveMap& operator= (const IntrusiveMap&) = delete;
+        IntrusiveMap& operator= (IntrusiveMap&& other) noexcept;
+
+        std::pair<iterator, bool> insert(T& value); // O(log n), value is not linked when its key is already present
+        iterator erase(iterator position);
+        void erase(T& value); // O(log n) with O(1) rotations, value must be linked into this map
+        iterator find(const Key& key);
+        iterator lower_bound(const Key& key); // the first element whose key is not less than key
+        void clear() noexcept; // unlinks every element
+        std::size_t size() const noexcept { return sz; }
+        bool empty() const noexcept { return sz == 0; }
+
+        iterator iterator_to(T& value) noexcept { return iterator(hook_of(value), this); }
+        iterator begin() { return iterator(leftmost(root), this); }
+        iterator end() { return iterator(nullptr, this); }
+    };
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    MapHook* IntrusiveMap<Key, T, Hook, KeyMember, Compare>::leftmost(MapHook* cur) noexcept {
+        if (cur) {
+            while (cur->left) cur = cur->left;
+        }
+        return cur;
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    MapHook* IntrusiveMap<Key, T, Hook, KeyMember, Compare>::rightmost(MapHook* cur) noexcept {
+        if (cur) {
+            while (cur->right) cur = cur->right;
+        }
+        return cur;
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    MapHook* IntrusiveMap<Key, T, Hook, KeyMember, Compare>::successor(MapHook* cur) noexcept {
+        if (cur->right) return leftmost(cur->right);
+        while (cur->parent && cur == cur->parent->right) cur = cur->parent;
+        return cur->parent;
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    MapHook* IntrusiveMap<Key, T, Hook, KeyMember, Compare>::predecessor(MapHook* cur) noexcept {
+        if (cur->left) return rightmost(cur->left);
+        while (cur->parent && cur == cur->parent->left) cur = cur->parent;
+        return cur->parent;
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    int IntrusiveMap<Key, T, Hook, KeyMember, Compare>::compare(const Key& lhs, const Key& rhs) const {
+        if constexpr (std::is_same_v<std::invoke_result_t<const Compare&, const Key&, const Key&>, bool>) {
+            if (comp(lhs, rhs)) return -1;
+            return comp(rhs, lhs) ? 1 : 0;
+        }
+        else {
+            auto order = comp(lhs, rhs);
+            return order < 0 ? -1 : (order > 0 ? 1 : 0);
+        }
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    void IntrusiveMap<Key, T, Hook, KeyMember, Compare>::replace_child(MapHook* parent, MapHook* old_child, MapHook* new_child) noexcept {
+        if (!parent) root = new_child;
+        else if (parent->left == old_child) parent->left = new_child;
+        else parent->right = new_child;
+        if (new_child) new_child->parent = parent;
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    void IntrusiveMap<Key, T, Hook, KeyMember, Compare>::left_rotation(MapHook* cur) noexcept {
+        MapHook* child = cur->right;
+        cur->right = child->left;
+        if (child->left) child->left->parent = cur;
+        replace_child(cur->parent, cur, child);
+        child->left = cur;
+        cur->parent = child;
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    void IntrusiveMap<Key, T, Hook, KeyMember, Compare>::right_rotation(MapHook* cur) noexcept {
+        MapHook* child = cur->left;
+        cur->left = child->right;
+        if (child->right) child->right->parent = cur;
+        replace_child(cur->parent, cur, child);
+        child->right = cur;
+        cur->parent = child;
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    void IntrusiveMap<Key, T, Hook, KeyMember, Compare>::balancing_after_insert(MapHook* cur) noexcept {
+        while (cur != root && cur->parent->color == Color::RED) {
+            MapHook* pParent = cur->parent;
+            MapHook* pGrandparent = pParent->parent;
+            bool parent_is_left = pParent == pGrandparent->left;
+            MapHook* pUncle = parent_is_left ? pGrandparent->right : pGrandparent->left;
+
+            if (color_of(pUncle) == Color::RED) {
+                pParent->color = Color::BLACK;
+                pUncle->color = Color::BLACK;
+                pGrandparent->color = Color::RED;
+                cur = pGrandparent;
+                continue;
+            }
+
+            if (parent_is_left) {
+                if (cur == pParent->right) {
+                    left_rotation(pParent);
+                    pParent = cur;
+                }
+                right_rotation(pGrandparent);
+            }
+            else {
+                if (cur == pParent->left) {
+                    right_rotation(pParent);
+                    pParent = cur;
+                }
+                left_rotation(pGrandparent);
+            }
+            pParent->color = Color::BLACK;
+            pGrandparent->color = Color::RED;
+            break;
+        }
+        root->color = Color::BLACK;
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    void IntrusiveMap<Key, T, Hook, KeyMember, Compare>::balancing_after_erase(MapHook* cur, MapHook* parent) noexcept {
+        // cur carries an extra black, it may be nullptr so its parent is passed separately
+        while (cur != root && color_of(cur) == Color::BLACK) {
+            if (cur == parent->left) {
+                MapHook* sibling = parent->right;
+                if (sibling->color == Color::RED) {
+                    sibling->color = Color::BLACK;
+                    parent->color = Color::RED;
+                    left_rotation(parent);
+                    sibling = parent->right;
+                }
+                if (color_of(sibling->left) == Color::BLACK && color_of(sibling->right) == Color::BLACK) {
+                    sibling->color = Color::RED;
+                    cur = parent;
+                    parent = cur->parent;
+                    continue;
+                }
+                if (color_of(sibling->right) == Color::BLACK) {
+                    sibling->left->color = Color::BLACK;
+                    sibling->color = Color::RED;
+                    right_rotation(sibling);
+                    sibling = parent->right;
+                }
+                sibling->color = parent->color;
+                parent->color = Color::BLACK;
+                sibling->right->color = Color::BLACK;
+                left_rotation(parent);
+            }
+            else {
+                MapHook* sibling = parent->left;
+                if (sibling->color == Color::RED) {
+                    sibling->color = Color::BLACK;
+                    parent->color = Color::RED;
+                    right_rotation(parent);
+                    sibling = parent->left;
+                }
+                if (color_of(sibling->left) == Color::BLACK && color_of(sibling->right) == Color::BLACK) {
+                    sibling->color = Color::RED;
+                    cur = parent;
+                    parent = cur->parent;
+                    continue;
+                }
+                if (color_of(sibling->left) == Color::BLACK) {
+                    sibling->right->color = Color::BLACK;
+                    sibling->color = Color::RED;
+                    left_rotation(sibling);
+                    sibling = parent->left;
+                }
+                sibling->color = parent->color;
+                parent->color = Color::BLACK;
+                sibling->left->color = Color::BLACK;
+                right_rotation(parent);
+            }
+            cur = root;
+        }
+        if (cur) cur->color = Color::BLACK;
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    void IntrusiveMap<Key, T, Hook, KeyMember, Compare>::unlink(MapHook* hook) noexcept {
+        MapHook* child;
+        MapHook* child_parent;
+        Color removed_color = hook->color;
+
+        if (!hook->left || !hook->right) {
+            child = hook->left ? hook->left : hook->right;
+            child_parent = hook->parent;
+            replace_child(hook->parent, hook, child);
+        }
+        else {
+            // the successor takes the place and the color of hook
+            MapHook* next = leftmost(hook->right);
+            removed_color = next->color;
+            child = next->right;
+            if (next->parent == hook) child_parent = next;
+            else {
+                child_parent = next->parent;
+                replace_child(next->parent, next, child);
+                next->right = hook->right;
+                next->right->parent = next;
+            }
+            replace_child(hook->parent, hook, next);
+            next->left = hook->left;
+            next->left->parent = next;
+            next->color = hook->color;
+        }
+
+        if (removed_color == Color::BLACK) balancing_after_erase(child, child_parent);
+
+        hook->left = hook->right = hook->parent = nullptr;
+        hook->owner = nullptr;
+        sz--;
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    IntrusiveMap<Key, T, Hook, KeyMember, Compare>::IntrusiveMap(IntrusiveMap&& other) noexcept : root(other.root), sz(other.sz), comp(std::move(other.comp)) {
+        other.root = nullptr;
+        other.sz = 0;
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    IntrusiveMap<Key, T, Hook, KeyMember, Compare>& IntrusiveMap<Key, T, Hook, KeyMember, Compare>::operator=(IntrusiveMap&& other) noexcept {
+        if (this != &other) {
+            clear();
+
+            root = other.root;
+            sz = other.sz;
+            comp = std::move(other.comp);
+            other.root = nullptr;
+            other.sz = 0;
+        }
+        return *this;
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    std::pair<typename IntrusiveMap<Key, T, Hook, KeyMember, Compare>::iterator, bool> IntrusiveMap<Key, T, Hook, KeyMember, Compare>::insert(T& value) {
+        MapHook* hook = hook_of(value);
+        if (hook->is_linked()) throw std::invalid_argument("intrusive map insert of a linked value."); // EXCEPTION
+
+        const Key& key = value.*KeyMember;
+        MapHook* parent = nullptr;
+        MapHook* cur = root;
+        int order = 0;
+        while (cur) {
+            order = compare(key, key_of(cur));
+            if (order == 0) return { iterator(cur, this), false };
+            parent = cur;
+            cur = order < 0 ? cur->left : cur->right;
+        }
+
+        hook->left = hook->right = nullptr;
+        hook->parent = parent;
+        hook->color = Color::RED;
+        hook->owner = &value;
+        if (!parent) root = hook;
+        else if (order < 0) parent->left = hook;
+        else parent->right = hook;
+        sz++;
+
+        balancing_after_insert(hook);
+        return { iterator(hook, this), true };
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    typename IntrusiveMap<Key, T, Hook, KeyMember, Compare>::iterator IntrusiveMap<Key, T, Hook, KeyMember, Compare>::erase(iterator position) {
+        if (sz == 0 || !position.ptr) throw std::out_of_range("intrusive map erase iterator outside range."); // EXCEPTION
+        iterator next(successor(position.ptr), this);
+        unlink(position.ptr);
+        return next;
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    void IntrusiveMap<Key, T, Hook, KeyMember, Compare>::erase(T& value) {
+        MapHook* hook = hook_of(value);
+        if (!hook->is_linked()) throw std::out_of_range("intrusive map erase of an unlinked value."); // EXCEPTION
+        unlink(hook);
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    typename IntrusiveMap<Key, T, Hook, KeyMember, Compare>::iterator IntrusiveMap<Key, T, Hook, KeyMember, Compare>::find(const Key& key) {
+        MapHook* cur = root;
+        while (cur) {
+            int order = compare(key, key_of(cur));
+            if (order == 0) return iterator(cur, this);
+            cur = order < 0 ? cur->left : cur->right;
+        }
+        return end();
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    typename IntrusiveMap<Key, T, Hook, KeyMember, Compare>::iterator IntrusiveMap<Key, T, Hook, KeyMember, Compare>::lower_bound(const Key& key) {
+        MapHook* cur = root;
+        MapHook* result = nullptr;
+        while (cur) {
+            if (compare(key_of(cur), key) < 0) cur = cur->right;
+            else {
+                result = cur;
+                cur = cur->left;
+            }
+        }
+        return iterator(result, this);
+    }
+
+    template<typename Key, typename T, MapHook T::* Hook, Key T::* KeyMember, typename Compare>
+    void IntrusiveMap<Key, T, Hook, KeyMember, Compare>::clear() noexcept {
+        // bottom-up walk through parent pointers, every hook is reset on the way
+        MapHook* cur = root;
+        while (cur) {
+            if (cur->left) cur = cur->left;
+            else if (cur->right) cur = cur->right;
+            else {
+                MapHook* parent = cur->parent;
+                if (parent) {
+                    if (parent->left == cur) parent->left = nullptr;
+                    else parent->right = nullptr;
+                }
+                cur->parent = nullptr;
+                cur->owner = nullptr;
+                cur = parent;
+            }
+        }
+        root = nullptr;
+        sz = 0;
+    }
+}
+
+#endif // !__INTRUSIVE_HPP__
\ No newline at end of file
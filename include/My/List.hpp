@@ -0,0 +1,562 @@
+﻿#pragma once
+#ifndef __LIST_HPP__
+#define __LIST_HPP__
+
+#include <iostream>
+#include <utility>
+#include <stdexcept>
+#include <initializer_list>
+#include <memory>
+#include <iterator>
+#include <functional>
+#include <cstddef>
+#include "Counters.hpp"
+
+namespace My {
+	template <typename T, typename Allocator = std::allocator<T>>
+	class List {
+		struct NodeBase {
+			NodeBase* next;
+			NodeBase* prev;
+		};
+		struct Node : NodeBase {
+			T val;
+		};
+		using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+		using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+		NodeBase sentinel; // circular list: sentinel.next is the first node, sentinel.prev is the last one, end() points to sentinel
+		NodeBase* free_nodes; // destroyed nodes kept for reuse, linked through next
+		std::size_t sz;
+		NodeAllocator alloc;
+		[[no_unique_address]] InstanceCounters counter;
+
+		template<typename... Args>
+		Node* create_node(Args&&... args);
+		void destroy_node(NodeBase* node) noexcept;
+		void release_free_nodes() noexcept;
+		void take_links(List& other) noexcept;
+		static void link_before(NodeBase* position, NodeBase* node) noexcept;
+		static void unlink(NodeBase* node) noexcept;
+		static void transfer(NodeBase* position, NodeBase* first, NodeBase* last) noexcept;
+		template<typename Compare>
+		static NodeBase* merge_runs(NodeBase* first, NodeBase* second, Compare& comp);
+
+	public:
+		class iterator {
+			NodeBase* ptr;
+		public:
+			using iterator_category = std::bidirectional_iterator_tag;
+			using value_type = T;
+			using difference_type = std::ptrdiff_t;
+			using pointer = T*;
+			using reference = T&;
+
+			friend class List;
+			iterator() = default;
+			iterator(NodeBase* _ptr) : ptr(_ptr) {}
+			iterator& operator++() { ptr = ptr->next; return *this; }
+			iterator operator++(int) { iterator tmp = *this;  ptr = ptr->next; return tmp; }
+			iterator& operator--() { ptr = ptr->prev; return *this; }
+			iterator operator--(int) { iterator tmp = *this;  ptr = ptr->prev; return tmp; }
+			bool operator==(const iterator& other) const noexcept { return ptr == other.ptr; }
+			bool operator!=(const iterator& other) const noexcept { return !(*this == other); }
+			T& operator*() const noexcept { return static_cast<Node*>(ptr)->val; }
+			T* operator->() const noexcept { return std::addressof(static_cast<Node*>(ptr)->val); }
+		};
+
+		List(const Allocator& _alloc = Allocator());
+		List(std::size_t size, const Allocator& _alloc = Allocator());
+		List(std::size_t size, const T& value, const Allocator& _alloc = Allocator());
+		List(std::initializer_list<T> init_list, const Allocator& _alloc = Allocator());
+		List(const List& other);
+		List(List&& other) noexcept;
+
+		~List();
+
+		List& operator= (const List& other);
+		List& operator= (List&& other) noexcept;
+
+		iterator insert(iterator position, const T& element);
+		iterator insert(iterator position, T&& element);
+		iterator insert(iterator position, int number, const T& element);
+		iterator insert(iterator position, std::initializer_list<T> init_list);
+		iterator erase(iterator first);
+		iterator erase(iterator first, iterator second);
+		template<typename... Args>
+		iterator emplace(iterator position, Args&&... args); // the element is constructed inside the node
+		void push_back(const T& element);
+		void push_back(T&& element);
+		void push_front(const T& element);
+		void push_front(T&& element);
+		template<typename... Args>
+		T& emplace_back(Args&&... args);
+		template<typename... Args>
+		T& emplace_front(Args&&... args);
+		void pop_back();
+		void pop_front();
+		void resize(int size);
+		void clear();
+		void shrink_to_fit() noexcept { release_free_nodes(); } // frees the nodes kept for reuse
+		T& front() const noexcept { return static_cast<Node*>(sentinel.next)->val; }
+		T& back() const noexcept { return static_cast<Node*>(sentinel.prev)->val; }
+		std::size_t size() const noexcept { return sz; }
+		bool empty() const noexcept { return sz == 0; }
+		Counters counters() const noexcept { return counter.get(); } // zeros unless MY_CONTAINERS_STATS is defined
+		void reset_counters() noexcept { counter.reset(); }
+
+		// splice and merge relink nodes without allocating or copying, both lists must use equal allocators
+		void splice(iterator position, List& other) noexcept; // O(1)
+		void splice(iterator position, List& other, iterator element) noexcept; // O(1)
+		void splice(iterator position, List& other, iterator first, iterator last) noexcept; // O(1) within one list, O(last - first) between lists
+		void merge(List& other) { merge(other, std::less<>()); }
+		template<typename Compare>
+		void merge(List& other, Compare comp); // both lists must be sorted, stable
+		void sort() { sort(std::less<>()); }
+		template<typename Compare>
+		void sort(Compare comp); // stable merge sort, O(n log n)
+
+		iterator begin() { return iterator(sentinel.next); };
+		iterator end() { return iterator(&sentinel); };
+	};
+
+	template<typename T, typename Allocator>
+	template<typename... Args>
+	typename List<T, Allocator>::Node* List<T, Allocator>::create_node(Args&&... args) {
+		Node* node;
+		if (free_nodes) {
+			node = static_cast<Node*>(free_nodes);
+			free_nodes = free_nodes->next;
+		}
+		else {
+			node = NodeTraits::allocate(alloc, 1);
+			counter.allocation();
+		}
+
+		try {
+			NodeTraits::construct(alloc, std::addressof(node->val), std::forward<Args>(args)...);
+			counter.construction<T, Args...>();
+		}
+		catch (...) {
+			node->next = free_nodes;
+			free_nodes = node;
+			throw;
+		}
+		return node;
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::destroy_node(NodeBase* node) noexcept {
+		NodeTraits::destroy(alloc, std::addressof(static_cast<Node*>(node)->val));
+		node->next = free_nodes;
+		free_nodes = node;
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::release_free_nodes() noexcept {
+		while (free_nodes) {
+			NodeBase* forward = free_nodes->next;
+			NodeTraits::deallocate(alloc, static_cast<Node*>(free_nodes), 1);
+			free_nodes = forward;
+		}
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::take_links(List& other) noexcept {
+		// the sentinel lives inside the list object, so the first and the last node have to be repointed to it
+		free_nodes = other.free_nodes;
+		sz = other.sz;
+		if (other.sz == 0) sentinel.next = sentinel.prev = &sentinel;
+		else {
+			sentinel.next = other.sentinel.next;
+			sentinel.prev = other.sentinel.prev;
+			sentinel.next->prev = &sentinel;
+			sentinel.prev->next = &sentinel;
+		}
+		other.sentinel.next = other.sentinel.prev = &other.sentinel;
+		other.free_nodes = nullptr;
+		other.sz = 0;
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::link_before(NodeBase* position, NodeBase* node) noexcept {
+		node->next = position;
+		node->prev = position->prev;
+		position->prev->next = node;
+		position->prev = node;
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::unlink(NodeBase* node) noexcept {
+		node->prev->next = node->next;
+		node->next->prev = node->prev;
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::transfer(NodeBase* position, NodeBase* first, NodeBase* last) noexcept {
+		// moves [first, last) before position, position must not be inside the range
+		if (first == last || position == last) return;
+
+		NodeBase* range_back = last->prev;
+		first->prev->next = last;
+		last->prev = first->prev;
+
+		first->prev = position->prev;
+		range_back->next = position;
+		position->prev->next = first;
+		position->prev = range_back;
+	}
+
+	template<typename T, typename Allocator>
+	template<typename Compare>
+	typename List<T, Allocator>::NodeBase* List<T, Allocator>::merge_runs(NodeBase* first, NodeBase* second, Compare& comp) {
+		// merges two null-terminated runs linked through next, ties are taken from first
+		NodeBase head;
+		NodeBase* tail = &head;
+		while (first && second) {
+			if (comp(static_cast<Node*>(second)->val, static_cast<Node*>(first)->val)) {
+				tail->next = second;
+				second = second->next;
+			}
+			else {
+				tail->next = first;
+				first = first->next;
+			}
+			tail = tail->next;
+		}
+		tail->next = first ? first : second;
+		return head.next;
+	}
+
+	template<typename T, typename Allocator>
+	List<T, Allocator>::List(const Allocator& _alloc) : free_nodes(nullptr), sz(0), alloc(_alloc) {
+		sentinel.next = sentinel.prev = &sentinel;
+	}
+
+	template<typename T, typename Allocator>
+	List<T, Allocator>::List(std::size_t size, const Allocator& _alloc) : List(_alloc) {
+		try {
+			for (std::size_t i = 0; i < size; i++) {
+				link_before(&sentinel, create_node());
+				sz++;
+			}
+		}
+		catch (...) {
+			clear();
+			release_free_nodes();
+			throw;
+		}
+	}
+
+	template<typename T, typename Allocator>
+	List<T, Allocator>::List(std::size_t size, const T& value, const Allocator& _alloc) : List(_alloc) {
+		try {
+			for (std::size_t i = 0; i < size; i++) {
+				link_before(&sentinel, create_node(value));
+				sz++;
+			}
+		}
+		catch (...) {
+			clear();
+			release_free_nodes();
+			throw;
+		}
+	}
+
+	template<typename T, typename Allocator>
+	List<T, Allocator>::List(std::initializer_list<T> init_list, const Allocator& _alloc) : List(_alloc) {
+		try {
+			for (auto& el : init_list) {
+				push_back(el);
+			}
+		}
+		catch (...) {
+			clear();
+			release_free_nodes();
+			throw;
+		}
+	}
+
+	template<typename T, typename Allocator>
+	List<T, Allocator>::List(const List& other) : List(NodeTraits::select_on_container_copy_construction(other.alloc)) {
+		try {
+			for (NodeBase* cur = other.sentinel.next; cur != &other.sentinel; cur = cur->next) {
+				push_back(static_cast<Node*>(cur)->val);
+			}
+		}
+		catch (...) {
+			clear();
+			release_free_nodes();
+			throw;
+		}
+	}
+
+	template<typename T, typename Allocator>
+	List<T, Allocator>::List(List&& other) noexcept : alloc(std::move(other.alloc)) { take_links(other); }
+
+	template<typename T, typename Allocator>
+	List<T, Allocator>::~List() {
+		clear();
+		release_free_nodes();
+	}
+
+	template<typename T, typename Allocator>
+	List<T, Allocator>& List<T, Allocator>::operator=(const List& other) {
+		if (this != &other) {
+			// existing nodes are assigned over, the rest is appended or erased
+			NodeBase* cur = sentinel.next;
+			NodeBase* other_cur = other.sentinel.next;
+			for (; cur != &sentinel && other_cur != &other.sentinel; cur = cur->next, other_cur = other_cur->next) {
+				static_cast<Node*>(cur)->val = static_cast<Node*>(other_cur)->val;
+				counter.copy();
+			}
+
+			if (other_cur == &other.sentinel) erase(iterator(cur), end());
+			else {
+				for (; other_cur != &other.sentinel; other_cur = other_cur->next) {
+					push_back(static_cast<Node*>(other_cur)->val);
+				}
+			}
+		}
+		return *this;
+	}
+
+	template<typename T, typename Allocator>
+	List<T, Allocator>& List<T, Allocator>::operator=(List&& other) noexcept {
+		if (this != &other) {
+			clear();
+			release_free_nodes();
+
+			alloc = std::move(other.alloc);
+			take_links(other);
+		}
+		return *this;
+	}
+
+	template<typename T, typename Allocator>
+	typename List<T, Allocator>::iterator List<T, Allocator>::insert(iterator position, const T& element) { return emplace(position, element); }
+
+	template<typename T, typename Allocator>
+	typename List<T, Allocator>::iterator List<T, Allocator>::insert(iterator position, T&& element) { return emplace(position, std::move(element)); }
+
+	template<typename T, typename Allocator>
+	template<typename... Args>
+	typename List<T, Allocator>::iterator List<T, Allocator>::emplace(iterator position, Args&&... args) {
+		Node* node = create_node(std::forward<Args>(args)...);
+		link_before(position.ptr, node);
+		sz++;
+
+		return iterator(node);
+	}
+
+	template<typename T, typename Allocator>
+	typename List<T, Allocator>::iterator List<T, Allocator>::insert(iterator position, int number, const T& element) {
+		if (number < 0) throw std::length_error("length error."); // EXCEPTION
+		iterator first = position;
+		for (int i = 0; i < number; i++) {
+			iterator cur_pos = insert(position, element);
+			if (i == 0) first = cur_pos;
+		}
+		return first;
+	}
+
+	template<typename T, typename Allocator>
+	typename List<T, Allocator>::iterator List<T, Allocator>::insert(iterator position, std::initializer_list<T> init_list) {
+		iterator first = position;
+		bool inserted = false;
+		for (auto& el : init_list) {
+			iterator cur_pos = insert(position, el);
+			if (!inserted) first = cur_pos;
+			inserted = true;
+		}
+		return first;
+	}
+
+	template<typename T, typename Allocator>
+	typename List<T, Allocator>::iterator List<T, Allocator>::erase(iterator first) {
+		if (sz == 0 || first.ptr == &sentinel) throw std::out_of_range("list erase iterator outside range."); // EXCEPTION
+
+		iterator cur_pos(first.ptr->next);
+		unlink(first.ptr);
+		destroy_node(first.ptr);
+		sz--;
+		return cur_pos;
+	}
+
+	template<typename T, typename Allocator>
+	typename List<T, Allocator>::iterator List<T, Allocator>::erase(iterator first, iterator second) {
+		while (first != second) {
+			first = erase(first);
+		}
+		return second;
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::push_back(const T& element) { emplace_back(element); }
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::push_back(T&& element) { emplace_back(std::move(element)); }
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::push_front(const T& element) { emplace_front(element); }
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::push_front(T&& element) { emplace_front(std::move(element)); }
+
+	template<typename T, typename Allocator>
+	template<typename... Args>
+	T& List<T, Allocator>::emplace_back(Args&&... args) {
+		Node* node = create_node(std::forward<Args>(args)...);
+		link_before(&sentinel, node);
+		sz++;
+		return node->val;
+	}
+
+	template<typename T, typename Allocator>
+	template<typename... Args>
+	T& List<T, Allocator>::emplace_front(Args&&... args) {
+		Node* node = create_node(std::forward<Args>(args)...);
+		link_before(sentinel.next, node);
+		sz++;
+		return node->val;
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::pop_back() {
+		if (!sz) throw std::out_of_range("pop_back called on empty list."); // EXCEPTION
+		NodeBase* node = sentinel.prev;
+		unlink(node);
+		destroy_node(node);
+		sz--;
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::pop_front() {
+		if (!sz) throw std::out_of_range("pop_front called on empty list."); // EXCEPTION
+		NodeBase* node = sentinel.next;
+		unlink(node);
+		destroy_node(node);
+		sz--;
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::resize(int size) {
+		if (size < 0) throw std::length_error("length error."); // EXCEPTION
+		while (sz < static_cast<std::size_t>(size)) {
+			link_before(&sentinel, create_node());
+			sz++;
+		}
+		while (sz > static_cast<std::size_t>(size)) {
+			pop_back();
+		}
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::clear() {
+		NodeBase* cur = sentinel.next;
+		while (cur != &sentinel) {
+			NodeBase* forward = cur->next;
+			destroy_node(cur);
+			cur = forward;
+		}
+		sentinel.next = sentinel.prev = &sentinel;
+		sz = 0;
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::splice(iterator position, List& other) noexcept {
+		if (this == &other || other.sz == 0) return;
+		transfer(position.ptr, other.sentinel.next, &other.sentinel);
+		sz += other.sz;
+		other.sz = 0;
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::splice(iterator position, List& other, iterator element) noexcept {
+		if (position.ptr == element.ptr || position.ptr == element.ptr->next) return;
+		transfer(position.ptr, element.ptr, element.ptr->next);
+		if (this != &other) {
+			sz++;
+			other.sz--;
+		}
+	}
+
+	template<typename T, typename Allocator>
+	void List<T, Allocator>::splice(iterator position, List& other, iterator first, iterator last) noexcept {
+		if (this != &other) {
+			std::size_t count = 0;
+			for (NodeBase* cur = first.ptr; cur != last.ptr; cur = cur->next) count++;
+			sz += count;
+			other.sz -= count;
+		}
+		transfer(position.ptr, first.ptr, last.ptr);
+	}
+
+	template<typename T, typename Allocator>
+	template<typename Compare>
+	void List<T, Allocator>::merge(List& other, Compare comp) {
+		if (this == &other) return;
+
+		NodeBase* cur = sentinel.next;
+		NodeBase* other_cur = other.sentinel.next;
+		while (cur != &sentinel && other_cur != &other.sentinel) {
+			if (comp(static_cast<Node*>(other_cur)->val, static_cast<Node*>(cur)->val)) {
+				// the whole run of other that goes before cur is moved at once
+				NodeBase* run_end = other_cur->next;
+				while (run_end != &other.sentinel && comp(static_cast<Node*>(run_end)->val, static_cast<Node*>(cur)->val)) {
+					run_end = run_end->next;
+				}
+				transfer(cur, other_cur, run_end);
+				other_cur = run_end;
+			}
+			else cur = cur->next;
+		}
+		transfer(&sentinel, other_cur, &other.sentinel);
+
+		sz += other.sz;
+		other.sz = 0;
+	}
+
+	template<typename T, typename Allocator>
+	template<typename Compare>
+	void List<T, Allocator>::sort(Compare comp) {
+		if (sz < 2) return;
+
+		// bottom-up merge sort on the nodes linked through next, runs[i] holds a sorted run of 2^i nodes
+		NodeBase* runs[sizeof(std::size_t) * 8] = {};
+		std::size_t max_level = 0;
+		NodeBase* cur = sentinel.next;
+		sentinel.prev->next = nullptr;
+		while (cur) {
+			NodeBase* run = cur;
+			cur = cur->next;
+			run->next = nullptr;
+
+			std::size_t level = 0;
+			for (; runs[level]; level++) {
+				run = merge_runs(runs[level], run, comp);
+				runs[level] = nullptr;
+			}
+			runs[level] = run;
+			if (level > max_level) max_level = level;
+		}
+
+		// lower levels hold later nodes, so they are merged in as the second run to keep the sort stable
+		NodeBase* sorted = nullptr;
+		for (std::size_t level = 0; level <= max_level; level++) {
+			if (runs[level]) sorted = merge_runs(runs[level], sorted, comp);
+		}
+
+		// restore prev links and close the circle
+		NodeBase* prev = &sentinel;
+		for (cur = sorted; cur; cur = cur->next) {
+			prev->next = cur;
+			cur->prev = prev;
+			prev = cur;
+		}
+		prev->next = &sentinel;
+		sentinel.prev = prev;
+	}
+}
+
+#endif // !__LIST_HPP__
\ No newline at end of file
@@ -0,0 +1,783 @@
+﻿#pragma once
+#ifndef __MAP_HPP__
+#define __MAP_HPP__
+
+#include <utility>
+#include <stdexcept>
+#include <initializer_list>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <memory>
+#include <compare>
+#include <functional>
+#include "Compare.hpp"
+#include "Counters.hpp"
+#include "Serialization.hpp"
+
+namespace My {
+    // Compare is either a three-way comparator returning an ordering (one call per visited node, the default uses operator<=> when the key has one)
+    // or a less-style comparator returning bool
+    // OrderStatistics = true keeps subtree sizes in the nodes, which enables nth() and rank() in O(log n)
+    template <typename T1, typename T2, typename Compare = DefaultCompare, bool OrderStatistics = false>
+    class Map {
+        enum class Color { BLACK, RED };
+
+        struct NoSubtreeSize {};
+        struct SubtreeSize { std::size_t subtree_size = 1; };
+
+        struct TreeNode : std::conditional_t<OrderStatistics, SubtreeSize, NoSubtreeSize> {
+            TreeNode(std::pair<T1, T2> _val, Color _color, TreeNode* _parent = nullptr) :
+                val(std::move(_val)), color(_color), left(nullptr), right(nullptr), parent(_parent) {}
+
+            std::pair<T1, T2> val;
+            Color color;
+            TreeNode* left;
+            TreeNode* right;
+            TreeNode* parent;
+        };
+
+        // nodes are carved out of contiguous chunks, destroyed nodes are kept for reuse
+        struct NodePool {
+            std::vector<std::pair<TreeNode*, std::size_t>> chunks;
+            std::vector<TreeNode*> released;
+            TreeNode* next = nullptr; // first unused node of the last chunk
+            TreeNode* chunk_end = nullptr;
+            std::size_t next_chunk_size = 16;
+            std::allocator<TreeNode> alloc;
+            [[no_unique_address]] InstanceCounters counter; // the allocations of the chunks
+
+            NodePool() = default;
+            NodePool(const NodePool&) = delete;
+            NodePool& operator=(const NodePool&) = delete;
+            ~NodePool() { release_all(); }
+
+            // the next n nodes created will be adjacent in memory
+            void reserve(std::size_t n) {
+                if (static_cast<std::size_t>(chunk_end - next) >= n) return;
+                for (; next != chunk_end; ++next) released.push_back(next);
+                next = alloc.allocate(n);
+                counter.allocation();
+                chunk_end = next + n;
+                chunks.push_back({ next, n });
+            }
+            template <typename... Args>
+            TreeNode* create(Args&&... args) {
+                TreeNode* node;
+                if (!released.empty()) {
+                    node = released.back();
+                    released.pop_back();
+                }
+                else {
+                    if (next == chunk_end) {
+                        reserve(next_chunk_size);
+                        if (next_chunk_size < 4096) next_chunk_size *= 2;
+                    }
+                    node = next++;
+                }
+                std::allocator_traits<std::allocator<TreeNode>>::construct(alloc, node, std::forward<Args>(args)...);
+                return node;
+            }
+            void destroy(TreeNode* node) {
+                std::allocator_traits<std::allocator<TreeNode>>::destroy(alloc, node);
+                released.push_back(node);
+            }
+            // every node must have been destroyed before
+            void release_all() noexcept {
+                for (auto& chunk : chunks) alloc.deallocate(chunk.first, chunk.second);
+                chunks.clear();
+                released.clear();
+                next = chunk_end = nullptr;
+                next_chunk_size = 16;
+            }
+        };
+
+        TreeNode* root;
+        TreeNode* max_node;
+        std::size_t sz;
+        std::shared_ptr<NodePool> pool; // created on first use like in My::Set, a move hands the pointer over
+        Compare comp;
+        [[no_unique_address]] InstanceCounters counter;
+
+        NodePool& node_pool();
+        void clear_traverse();
+        void copy_traverse(const Map& other);
+        TreeNode* get_max_node(TreeNode* cur) const;
+        int compare(const T1& lhs, const T1& rhs) const;
+        void balancing_after_insert(TreeNode* cur);
+        void right_rotation(TreeNode* y, TreeNode* g);
+        void left_rotation(TreeNode* y, TreeNode* g);
+        static std::size_t subtree_size(const TreeNode* cur) noexcept;
+        void update_subtree_size(TreeNode* cur) noexcept;
+        void increase_subtree_sizes(TreeNode* inserted) noexcept;
+        template <typename InputIt> void assign_sorted(InputIt first, InputIt last);
+        TreeNode* build_balanced(std::vector<TreeNode*>& nodes, std::size_t lo, std::size_t hi, std::size_t depth, std::size_t red_depth, TreeNode* parent);
+        TreeNode* read_balanced(SerializationDetail::Reader& reader, TreeNode*& last, std::size_t lo, std::size_t hi, std::size_t depth, std::size_t red_depth);
+        void drop_subtree(TreeNode* top);
+
+    public:
+        class iterator {
+            TreeNode* ptr;
+            Map* this_map;
+        public:
+            iterator() = default;
+            iterator(TreeNode* _ptr, Map* _this_map) : ptr(_ptr), this_map(_this_map) {}
+            bool operator ==(const iterator& other) { return ptr == other.ptr; }
+            bool operator !=(const iterator& other) { return !(*this == other); }
+            iterator& operator++() {
+                if (ptr->right) {
+                    ptr = ptr->right;
+                    while (ptr->left) ptr = ptr->left;
+                }
+                else {
+                    while (ptr->parent && ptr == ptr->parent->right) ptr = ptr->parent;
+                    ptr = ptr->parent;
+                }
+                return *this;
+            }
+            iterator operator++(int) {
+                iterator tmp = *this;
+                ++* this;
+                return tmp;
+            }
+            const std::pair<T1, T2>& operator*() { return ptr->val; }
+        };
+
+        Map(const Compare& _comp = Compare());
+        Map(std::initializer_list<std::pair<T1, T2>> init_list, const Compare& _comp = Compare());
+        Map(const Map& other);
+        Map(Map&& other) noexcept;
+
+        ~Map();
+
+        // builds a balanced red-black tree in O(n), [first, last) must be sorted by key, for equal keys the last value wins;
+        // throws std::invalid_argument on a key smaller than the one before it
+        template <typename InputIt> static Map from_sorted(InputIt first, InputIt last, const Compare& _comp = Compare());
+        // sorts a copy of [first, last) by key and then builds the tree with from_sorted()
+        template <typename InputIt> static Map from_unsorted(InputIt first, InputIt last, const Compare& _comp = Compare());
+
+        Map& operator=(const Map& other);
+        Map& operator=(Map&& other) noexcept;
+        T2& operator[](T1 key);
+
+        void insert(const T1& key, const T2& value);
+        void insert(std::pair<T1, T2> value);
+        T2& at(const T1& key);
+        void clear();
+        bool empty() const noexcept;
+        std::size_t size() const noexcept;
+        bool count(const T1& key) const noexcept;
+
+        // available only with OrderStatistics = true
+        iterator nth(std::size_t index); // the element with 0-based position index in sorted order
+        std::size_t rank(const T1& key) const noexcept; // the number of keys less than key
+
+        // compact binary snapshot in sorted order, see Serialization.hpp for the format
+        void write_to(std::ostream& out) const; // streams through a fixed size buffer, no copy of the elements is made
+        // replaces the contents, the tree is built bottom-up in O(n) as the elements arrive; a failed read leaves the map empty
+        void read_from(std::istream& in);
+
+        Counters counters() const noexcept; // zeros unless MY_CONTAINERS_STATS is defined
+        void reset_counters() noexcept;
+
+        iterator begin();
+        iterator end();
+    };
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    typename Map<T1, T2, Compare, OrderStatistics>::NodePool& Map<T1, T2, Compare, OrderStatistics>::node_pool() {
+        if (!pool) pool = std::make_shared<NodePool>();
+        return *pool;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::clear_traverse() {
+        // values that need no destructor call are released together with the chunks
+        if constexpr (!std::is_trivially_destructible_v<TreeNode>) drop_subtree(root);
+        pool->release_all();
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::drop_subtree(TreeNode* top) {
+        if (!top) return;
+
+        // bottom-up walk through parent pointers, it stops when it climbs above top
+        top->parent = nullptr;
+        TreeNode* cur = top;
+        while (cur) {
+            if (cur->left) cur = cur->left;
+            else if (cur->right) cur = cur->right;
+            else {
+                TreeNode* parent = cur->parent;
+                if (parent) {
+                    if (parent->left == cur) parent->left = nullptr;
+                    else parent->right = nullptr;
+                }
+                pool->destroy(cur);
+                cur = parent;
+            }
+        }
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::copy_traverse(const Map& other) {
+        node_pool().reserve(other.sz);
+        counter.copy(other.sz);
+        root = node_pool().create(other.root->val, other.root->color);
+        if constexpr (OrderStatistics) root->subtree_size = other.root->subtree_size;
+
+        // preorder walk over both trees at once, a missing child in the copy means it was not visited yet
+        const TreeNode* other_cur = other.root;
+        TreeNode* cur = root;
+        while (other_cur) {
+            if (other_cur->left && !cur->left) {
+                cur->left = node_pool().create(other_cur->left->val, other_cur->left->color, cur);
+                if constexpr (OrderStatistics) cur->left->subtree_size = other_cur->left->subtree_size;
+                other_cur = other_cur->left;
+                cur = cur->left;
+            }
+            else if (other_cur->right && !cur->right) {
+                cur->right = node_pool().create(other_cur->right->val, other_cur->right->color, cur);
+                if constexpr (OrderStatistics) cur->right->subtree_size = other_cur->right->subtree_size;
+                other_cur = other_cur->right;
+                cur = cur->right;
+            }
+            else {
+                other_cur = other_cur->parent;
+                cur = cur->parent;
+            }
+        }
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    int Map<T1, T2, Compare, OrderStatistics>::compare(const T1& lhs, const T1& rhs) const {
+        if constexpr (std::is_same_v<std::invoke_result_t<const Compare&, const T1&, const T1&>, bool>) {
+            if (comp(lhs, rhs)) return -1;
+            return comp(rhs, lhs) ? 1 : 0;
+        }
+        else {
+            auto order = comp(lhs, rhs);
+            return order < 0 ? -1 : (order > 0 ? 1 : 0);
+        }
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::balancing_after_insert(TreeNode* cur) {
+        if (cur == root) {
+            cur->color = Color::BLACK;
+            return;
+        }
+
+        TreeNode* pParent = cur->parent;
+        TreeNode* pGrandparent = nullptr;
+        if (pParent->parent) pGrandparent = pParent->parent;
+        if (!pGrandparent) return;
+
+        TreeNode* pUncle = nullptr;
+        if (pParent == pGrandparent->left) {
+            if (pGrandparent->right) pUncle = pGrandparent->right;
+        }
+        else {
+            if (pGrandparent->left) pUncle = pGrandparent->left;
+        }
+
+        if (!pUncle || pUncle->color == Color::BLACK) {
+            if ((cur == pParent->left && pParent == pGrandparent->left) || (cur == pParent->right && pParent == pGrandparent->right)) {
+                if (cur == pParent->left && pParent == pGrandparent->left) {
+                    right_rotation(pParent, pGrandparent);
+                }
+                else {
+                    left_rotation(pParent, pGrandparent);
+                }
+                pGrandparent->color = Color::RED;
+                pParent->color = Color::BLACK;
+            }
+            else {
+                if (cur == pParent->right && pParent == pGrandparent->left) {
+                    left_rotation(cur, pParent);
+                    right_rotation(cur, pGrandparent);
+                }
+                else {
+                    right_rotation(cur, pParent);
+                    left_rotation(cur, pGrandparent);
+                }
+                pGrandparent->color = Color::RED;
+                cur->color = Color::BLACK;
+            }
+        }
+        else {
+            pUncle->color = Color::BLACK;
+            pParent->color = Color::BLACK;
+            pGrandparent->color = Color::RED;
+            if (pGrandparent == root || pGrandparent->parent->color == Color::RED) balancing_after_insert(pGrandparent);
+        }
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::right_rotation(TreeNode* pChild, TreeNode* pParent) {
+        counter.rotation();
+        pChild->parent = pParent->parent;
+
+        if (pParent != root) {
+            if (pParent->parent->left == pParent) pParent->parent->left = pChild;
+            else if (pParent->parent->right == pParent) pParent->parent->right = pChild;
+        }
+        pParent->parent = pChild;
+
+        pParent->left = pChild->right;
+        if (pChild->right) pChild->right->parent = pParent;
+        pChild->right = pParent;
+
+        if (pParent == root) root = pChild;
+
+        update_subtree_size(pParent);
+        update_subtree_size(pChild);
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::left_rotation(TreeNode* pChild, TreeNode* pParent) {
+        counter.rotation();
+        pChild->parent = pParent->parent;
+
+        if (pParent != root) {
+            if (pParent->parent->left == pParent) pParent->parent->left = pChild;
+            else if (pParent->parent->right == pParent) pParent->parent->right = pChild;
+        }
+        pParent->parent = pChild;
+
+        pParent->right = pChild->left;
+        if (pChild->left) pChild->left->parent = pParent;
+        pChild->left = pParent;
+
+        if (pParent == root) root = pChild;
+
+        update_subtree_size(pParent);
+        update_subtree_size(pChild);
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    std::size_t Map<T1, T2, Compare, OrderStatistics>::subtree_size(const TreeNode* cur) noexcept {
+        if constexpr (OrderStatistics) return cur ? cur->subtree_size : 0;
+        else return 0;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::update_subtree_size(TreeNode* cur) noexcept {
+        if constexpr (OrderStatistics) cur->subtree_size = 1 + subtree_size(cur->left) + subtree_size(cur->right);
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::increase_subtree_sizes(TreeNode* inserted) noexcept {
+        if constexpr (OrderStatistics) {
+            for (TreeNode* cur = inserted->parent; cur; cur = cur->parent) cur->subtree_size++;
+        }
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    template<typename InputIt>
+    void Map<T1, T2, Compare, OrderStatistics>::assign_sorted(InputIt first, InputIt last) {
+        std::vector<TreeNode*> nodes;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>) {
+            nodes.reserve(std::distance(first, last));
+            node_pool().reserve(nodes.capacity());
+        }
+
+        for (; first != last; ++first) {
+            std::pair<T1, T2> value = *first;
+            counter.construction<std::pair<T1, T2>, decltype(*first)>();
+            if (!nodes.empty()) {
+                int order = compare(nodes.back()->val.first, value.first);
+                if (order == 0) {
+                    nodes.back()->val.second = std::move(value.second);
+                    continue;
+                }
+                if (order > 0) {
+                    for (TreeNode* node : nodes) pool->destroy(node);
+                    throw std::invalid_argument("Map::from_sorted() needs keys in ascending order, use from_unsorted()."); // EXCEPTION
+                }
+            }
+            nodes.push_back(node_pool().create(std::move(value), Color::BLACK));
+        }
+        if (nodes.empty()) return;
+
+        // levels 0 .. red_depth - 1 are complete, so the nodes of the last (incomplete) level are colored red
+        std::size_t red_depth = 0;
+        while ((std::size_t(2) << red_depth) - 1 <= nodes.size()) red_depth++;
+
+        root = build_balanced(nodes, 0, nodes.size(), 0, red_depth, nullptr);
+        max_node = nodes.back();
+        sz = nodes.size();
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    typename Map<T1, T2, Compare, OrderStatistics>::TreeNode* Map<T1, T2, Compare, OrderStatistics>::build_balanced(std::vector<TreeNode*>& nodes, std::size_t lo, std::size_t hi, std::size_t depth, std::size_t red_depth, TreeNode* parent) {
+        if (lo >= hi) return nullptr;
+
+        std::size_t mid = lo + (hi - lo) / 2;
+        TreeNode* cur = nodes[mid];
+        cur->parent = parent;
+        cur->color = depth == red_depth ? Color::RED : Color::BLACK;
+        cur->left = build_balanced(nodes, lo, mid, depth + 1, red_depth, cur);
+        cur->right = build_balanced(nodes, mid + 1, hi, depth + 1, red_depth, cur);
+        if constexpr (OrderStatistics) cur->subtree_size = hi - lo;
+        return cur;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    typename Map<T1, T2, Compare, OrderStatistics>::TreeNode* Map<T1, T2, Compare, OrderStatistics>::read_balanced(SerializationDetail::Reader& reader, TreeNode*& last, std::size_t lo, std::size_t hi, std::size_t depth, std::size_t red_depth) {
+        if (lo >= hi) return nullptr;
+
+        // the same shape as build_balanced(), but the nodes are created in order while the subtrees are linked
+        std::size_t mid = lo + (hi - lo) / 2;
+        TreeNode* left = read_balanced(reader, last, lo, mid, depth + 1, red_depth);
+        TreeNode* cur;
+        try {
+            T1 key = reader.read_key<T1>();
+            T2 value = reader.read_value<T2>();
+            if (last && compare(last->val.first, key) >= 0) reader.corrupt();
+            cur = node_pool().create(std::pair<T1, T2>(std::move(key), std::move(value)), depth == red_depth ? Color::RED : Color::BLACK);
+        }
+        catch (...) {
+            drop_subtree(left);
+            throw;
+        }
+        last = cur;
+        cur->left = left;
+        if (left) left->parent = cur;
+        try {
+            cur->right = read_balanced(reader, last, mid + 1, hi, depth + 1, red_depth);
+        }
+        catch (...) {
+            drop_subtree(cur);
+            throw;
+        }
+        if (cur->right) cur->right->parent = cur;
+        if constexpr (OrderStatistics) cur->subtree_size = hi - lo;
+        return cur;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    typename Map<T1, T2, Compare, OrderStatistics>::TreeNode* Map<T1, T2, Compare, OrderStatistics>::get_max_node(TreeNode* cur) const {
+        while (cur->right) cur = cur->right;
+        return cur;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    Map<T1, T2, Compare, OrderStatistics>::Map(const Compare& _comp) : sz(0), root(nullptr), max_node(nullptr), comp(_comp) {}
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    Map<T1, T2, Compare, OrderStatistics>::Map(std::initializer_list<std::pair<T1, T2>> init_list, const Compare& _comp) : Map(_comp) {
+        std::vector<std::pair<T1, T2>> sorted(init_list.begin(), init_list.end());
+        std::stable_sort(sorted.begin(), sorted.end(), [this](const std::pair<T1, T2>& a, const std::pair<T1, T2>& b) { return compare(a.first, b.first) < 0; });
+        assign_sorted(std::make_move_iterator(sorted.begin()), std::make_move_iterator(sorted.end()));
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    Map<T1, T2, Compare, OrderStatistics>::Map(const Map& other) : sz(other.sz), comp(other.comp) {
+        if (other.root) {
+            copy_traverse(other);
+            max_node = get_max_node(root);
+        }
+        else root = max_node = nullptr;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    Map<T1, T2, Compare, OrderStatistics>::Map(Map&& other) noexcept : sz(other.sz), root(other.root), max_node(other.max_node), pool(std::move(other.pool)), comp(std::move(other.comp)) {
+        other.root = nullptr;
+        other.max_node = nullptr;
+        other.sz = 0;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    Map<T1, T2, Compare, OrderStatistics>::~Map() { clear(); }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    template<typename InputIt>
+    Map<T1, T2, Compare, OrderStatistics> Map<T1, T2, Compare, OrderStatistics>::from_sorted(InputIt first, InputIt last, const Compare& _comp) {
+        Map result(_comp);
+        result.assign_sorted(first, last);
+        return result;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    template<typename InputIt>
+    Map<T1, T2, Compare, OrderStatistics> Map<T1, T2, Compare, OrderStatistics>::from_unsorted(InputIt first, InputIt last, const Compare& _comp) {
+        Map result(_comp);
+        std::vector<std::pair<T1, T2>> sorted(first, last);
+        std::stable_sort(sorted.begin(), sorted.end(), [&result](const std::pair<T1, T2>& a, const std::pair<T1, T2>& b) { return result.compare(a.first, b.first) < 0; });
+        result.assign_sorted(std::make_move_iterator(sorted.begin()), std::make_move_iterator(sorted.end()));
+        return result;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    Map<T1, T2, Compare, OrderStatistics>& Map<T1, T2, Compare, OrderStatistics>::operator=(const Map& other) {
+        if (this != &other) {
+            clear();
+
+            sz = other.sz;
+            comp = other.comp;
+            if (other.root) {
+                copy_traverse(other);
+                max_node = get_max_node(root);
+            }
+            else root = max_node = nullptr;
+        }
+        return *this;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    Map<T1, T2, Compare, OrderStatistics>& Map<T1, T2, Compare, OrderStatistics>::operator=(Map&& other) noexcept {
+        if (this != &other) {
+            clear();
+
+            sz = other.sz;
+            root = other.root;
+            max_node = other.max_node;
+            pool = std::move(other.pool);
+            comp = std::move(other.comp);
+
+            other.sz = 0;
+            other.root = nullptr;
+            other.max_node = nullptr;
+        }
+        return *this;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    T2& Map<T1, T2, Compare, OrderStatistics>::operator[](T1 key) { return at(key); }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::insert(const T1& key, const T2& value) {
+        counter.copy(); // into a new node or over the old value
+        if (!root) {
+            root = node_pool().create(std::pair<T1, T2>(key, value), Color::BLACK);
+            max_node = root;
+            sz++;
+            return;
+        }
+
+        bool can_be_max = true;
+        TreeNode* cur = root;
+        while (true) {
+            int order = compare(key, cur->val.first);
+            if (order > 0) {
+                if (cur->right) cur = cur->right;
+                else {
+                    cur->right = node_pool().create(std::pair<T1, T2>(key, value), Color::RED, cur);
+                    increase_subtree_sizes(cur->right);
+                    if (can_be_max) max_node = cur->right;
+                    if (cur->color == Color::RED) balancing_after_insert(cur->right);
+                    break;
+                }
+            }
+            else if (order < 0) {
+                can_be_max = false;
+                if (cur->left) cur = cur->left;
+                else {
+                    cur->left = node_pool().create(std::pair<T1, T2>(key, value), Color::RED, cur);
+                    increase_subtree_sizes(cur->left);
+                    if (cur->color == Color::RED) balancing_after_insert(cur->left);
+                    break;
+                }
+            }
+            else {
+                cur->val.second = value;
+                return;
+            }
+        }
+        sz++;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::insert(std::pair<T1, T2> value) {
+        insert(value.first, value.second);
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    T2& Map<T1, T2, Compare, OrderStatistics>::at(const T1& key) {
+        if (!root) {
+            root = node_pool().create(std::pair<T1, T2>(key, T2()), Color::BLACK);
+            counter.copy();
+            max_node = root;
+            sz++;
+            return root->val.second;
+        }
+
+        bool can_be_max = true;
+        TreeNode* cur = root;
+        while (true) {
+            int order = compare(key, cur->val.first);
+            if (order > 0) {
+                if (cur->right) cur = cur->right;
+                else {
+                    TreeNode* inserted = cur->right = node_pool().create(std::pair<T1, T2>(key, T2()), Color::RED, cur);
+                    counter.copy();
+                    increase_subtree_sizes(inserted);
+                    if (can_be_max) max_node = inserted;
+                    if (cur->color == Color::RED) balancing_after_insert(inserted);
+                    sz++;
+                    return inserted->val.second;
+                }
+            }
+            else if (order < 0) {
+                can_be_max = false;
+                if (cur->left) cur = cur->left;
+                else {
+                    TreeNode* inserted = cur->left = node_pool().create(std::pair<T1, T2>(key, T2()), Color::RED, cur);
+                    counter.copy();
+                    increase_subtree_sizes(inserted);
+                    if (cur->color == Color::RED) balancing_after_insert(inserted);
+                    sz++;
+                    return inserted->val.second;
+                }
+            }
+            else return cur->val.second;
+        }
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::clear() {
+        if (!root) return;
+
+        clear_traverse();
+
+        sz = 0;
+        root = max_node = nullptr;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    bool Map<T1, T2, Compare, OrderStatistics>::empty() const noexcept { return sz == 0; }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    std::size_t Map<T1, T2, Compare, OrderStatistics>::size() const noexcept { return sz; }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    bool Map<T1, T2, Compare, OrderStatistics>::count(const T1& key) const noexcept {
+        if (!root) return false;
+
+        TreeNode* cur = root;
+        while (true) {
+            int order = compare(key, cur->val.first);
+            if (order > 0) {
+                if (cur->right) cur = cur->right;
+                else return false;
+            }
+            else if (order < 0) {
+                if (cur->left) cur = cur->left;
+                else return false;
+            }
+            else return true;
+        }
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    typename Map<T1, T2, Compare, OrderStatistics>::iterator Map<T1, T2, Compare, OrderStatistics>::nth(std::size_t index) {
+        static_assert(OrderStatistics, "nth() requires OrderStatistics = true");
+        if (index >= sz) throw std::out_of_range("map nth index outside range."); // EXCEPTION
+
+        TreeNode* cur = root;
+        while (true) {
+            std::size_t left_size = subtree_size(cur->left);
+            if (index < left_size) cur = cur->left;
+            else if (index > left_size) {
+                index -= left_size + 1;
+                cur = cur->right;
+            }
+            else return iterator(cur, this);
+        }
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    std::size_t Map<T1, T2, Compare, OrderStatistics>::rank(const T1& key) const noexcept {
+        static_assert(OrderStatistics, "rank() requires OrderStatistics = true");
+
+        std::size_t less = 0;
+        TreeNode* cur = root;
+        while (cur) {
+            if (compare(key, cur->val.first) > 0) {
+                less += subtree_size(cur->left) + 1;
+                cur = cur->right;
+            }
+            else cur = cur->left;
+        }
+        return less;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::write_to(std::ostream& out) const {
+        SerializationDetail::Writer writer(out);
+        writer.write_header<T1, T2>('M', sz);
+        if (root) {
+            const TreeNode* cur = root;
+            while (cur->left) cur = cur->left;
+            while (cur) {
+                writer.write_key(cur->val.first);
+                writer.write_value(cur->val.second);
+                if (cur->right) {
+                    cur = cur->right;
+                    while (cur->left) cur = cur->left;
+                }
+                else {
+                    while (cur->parent && cur == cur->parent->right) cur = cur->parent;
+                    cur = cur->parent;
+                }
+            }
+        }
+        writer.flush();
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::read_from(std::istream& in) {
+        clear();
+        SerializationDetail::Reader reader(in);
+        std::size_t count = reader.read_header<T1, T2>('M');
+        if (!count) return;
+
+        // the count comes from the stream, so only a bounded part is reserved up front and the pool grows as the nodes
+        // are read; a count past the end of the data ends in the reader's "Unexpected end of the stream."
+        node_pool().reserve(std::min(count, SerializationDetail::CHUNK_SIZE));
+        // levels 0 .. red_depth - 1 are complete, so the nodes of the last (incomplete) level are colored red
+        std::size_t red_depth = 0;
+        while ((std::size_t(2) << red_depth) - 1 <= count) red_depth++;
+
+        TreeNode* last = nullptr;
+        root = read_balanced(reader, last, 0, count, 0, red_depth);
+        max_node = last;
+        sz = count;
+        counter.move(count);
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    Counters Map<T1, T2, Compare, OrderStatistics>::counters() const noexcept {
+        Counters result = counter.get();
+        if (pool) result.allocations += pool->counter.get().allocations;
+        return result;
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    void Map<T1, T2, Compare, OrderStatistics>::reset_counters() noexcept {
+        counter.reset();
+        if (pool) pool->counter.reset();
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    typename Map<T1, T2, Compare, OrderStatistics>::iterator Map<T1, T2, Compare, OrderStatistics>::begin() {
+        if (!root) return iterator(nullptr, this);
+
+        TreeNode* cur = root;
+        while (cur->left) {
+            cur = cur->left;
+        }
+        return iterator(cur, this);
+    }
+
+    template<typename T1, typename T2, typename Compare, bool OrderStatistics>
+    typename Map<T1, T2, Compare, OrderStatistics>::iterator Map<T1, T2, Compare, OrderStatistics>::end() {
+        if (!root) return iterator(nullptr, this);
+
+        return iterator(max_node->right, this);
+    }
+}
+
+#endif // !__MAP_HPP__
\ No newline at end of file
@@ -0,0 +1,283 @@
+﻿#pragma once
+#ifndef __MAPPED_VECTOR_HPP__
+#define __MAPPED_VECTOR_HPP__
+
+#include <string>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include "Vector.hpp"
+#include "Counters.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#error "My::MappedVector needs mmap"
+#endif
+
+namespace My {
+    // the madvise() hint for the whole mapping
+    enum class Access { NORMAL, SEQUENTIAL, RANDOM };
+
+    // A vector of trivially copyable records that lives in a file. The file is mapped shared, so the elements are
+    // read and written in place by the page cache without any read()/write() calls and may be larger than RAM.
+    // The file starts with a 64 byte header that keeps the size, the elements follow; growing extends the file with
+    // ftruncate() and the mapping with mremap() (munmap() and mmap() where mremap() does not exist). The capacity
+    // beyond the size is a hole in the file and takes no disk space. Reopening the file restores the vector.
+    template<typename T>
+    class MappedVector {
+        static_assert(std::is_trivially_copyable_v<T>, "My::MappedVector needs a trivially copyable element type.");
+
+        static constexpr std::size_t HEADER_SIZE = 64;
+        static_assert(alignof(T) <= HEADER_SIZE, "My::MappedVector supports alignments up to 64 bytes.");
+        static constexpr std::uint32_t FILE_VERSION = 1;
+
+        struct FileHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t element_size;
+            std::uint64_t size;
+        };
+
+        int fd;
+        char* region; // the header followed by cp elements
+        std::size_t region_length;
+        std::size_t cp; // capacity
+        Access access;
+        [[no_unique_address]] InstanceCounters counter;
+
+        FileHeader* header() const noexcept { return reinterpret_cast<FileHeader*>(region); }
+        T* data() const noexcept { return reinterpret_cast<T*>(region + HEADER_SIZE); }
+        void set_size(std::size_t size) noexcept { header()->size = size; }
+        void remap(std::size_t capacity);
+        void apply_access() noexcept;
+        void release() noexcept;
+        [[noreturn]] static void fail(const std::string& message);
+
+    public:
+        using iterator = typename Vector<T>::iterator;
+
+        // opens path or creates it if it does not exist
+        explicit MappedVector(const std::string& path, Access _access = Access::NORMAL);
+        MappedVector(const MappedVector&) = delete;
+        MappedVector(MappedVector&& other) noexcept;
+
+        ~MappedVector(); // unmaps without waiting for the disk, call flush() for durability
+
+        MappedVector& operator =(const MappedVector&) = delete;
+        MappedVector& operator =(MappedVector&& other) noexcept;
+        T& operator[](std::size_t index) const noexcept { return data()[index]; }
+
+        void push_back(const T& element);
+        void pop_back();
+        std::size_t size() const noexcept { return region ? static_cast<std::size_t>(header()->size) : 0; }
+        std::size_t capacity() const noexcept { return cp; }
+        void resize(std::size_t size); // new elements are zero, as read from the extended file
+        void reserve(std::size_t capacity);
+        void shrink_to_fit(); // truncates the file to the size
+        void clear() noexcept { set_size(0); }
+        bool empty() const noexcept { return size() == 0; }
+        T& front() const;
+        T& back() const;
+        T& at(std::size_t index) const;
+
+        void flush(); // msync(), returns when the elements and the size are on disk
+        void advise(Access _access) noexcept; // kept across growth
+        Counters counters() const noexcept { return counter.get(); } // zeros unless MY_CONTAINERS_STATS is defined
+        void reset_counters() noexcept { counter.reset(); }
+
+        iterator begin() { return iterator(data()); }
+        iterator end() { return iterator(data() + size()); }
+    };
+
+    template<typename T>
+    void MappedVector<T>::fail(const std::string& message) {
+        throw std::runtime_error(message + ": " + std::strerror(errno)); // EXCEPTION
+    }
+
+    template<typename T>
+    MappedVector<T>::MappedVector(const std::string& path, Access _access) : fd(-1), region(nullptr), region_length(0), cp(0), access(_access) {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) fail("Cannot open " + path);
+
+        struct stat file_stat;
+        if (::fstat(fd, &file_stat) != 0) {
+            ::close(fd);
+            fail("Cannot stat " + path);
+        }
+        std::size_t file_length = static_cast<std::size_t>(file_stat.st_size);
+        bool created = file_length == 0;
+        if (created) {
+            // a new file starts with a page worth of elements
+            file_length = HEADER_SIZE + std::max<std::size_t>(1, 4096 / sizeof(T)) * sizeof(T);
+            if (::ftruncate(fd, static_cast<off_t>(file_length)) != 0) {
+                ::close(fd);
+                fail("Cannot extend " + path);
+            }
+        }
+        else if (file_length < HEADER_SIZE) {
+            ::close(fd);
+            throw std::runtime_error(path + " is not a MappedVector file."); // EXCEPTION
+        }
+
+        void* mapped = ::mmap(nullptr, file_length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            fail("Cannot map " + path);
+        }
+        region = static_cast<char*>(mapped);
+        region_length = file_length;
+        cp = (file_length - HEADER_SIZE) / sizeof(T);
+        counter.allocation();
+
+        if (created) {
+            std::memcpy(header()->magic, "MYMVEC\0", sizeof(header()->magic));
+            header()->version = FILE_VERSION;
+            header()->element_size = sizeof(T);
+            set_size(0);
+        }
+        else if (std::memcmp(header()->magic, "MYMVEC\0", sizeof(header()->magic)) != 0 || header()->version != FILE_VERSION
+            || header()->element_size != sizeof(T) || header()->size > cp) {
+            release();
+            throw std::runtime_error(path + " is not a MappedVector file of this element type."); // EXCEPTION
+        }
+        apply_access();
+    }
+
+    template<typename T>
+    MappedVector<T>::MappedVector(MappedVector&& other) noexcept : fd(other.fd), region(other.region), region_length(other.region_length), cp(other.cp), access(other.access) {
+        other.fd = -1;
+        other.region = nullptr;
+        other.region_length = 0;
+        other.cp = 0;
+    }
+
+    template<typename T>
+    MappedVector<T>::~MappedVector() { release(); }
+
+    template<typename T>
+    MappedVector<T>& MappedVector<T>::operator =(MappedVector&& other) noexcept {
+        if (this != &other) {
+            release();
+            fd = other.fd;
+            region = other.region;
+            region_length = other.region_length;
+            cp = other.cp;
+            access = other.access;
+
+            other.fd = -1;
+            other.region = nullptr;
+            other.region_length = 0;
+            other.cp = 0;
+        }
+        return *this;
+    }
+
+    template<typename T>
+    void MappedVector<T>::release() noexcept {
+        if (region) ::munmap(region, region_length);
+        if (fd >= 0) ::close(fd);
+        region = nullptr;
+        fd = -1;
+    }
+
+    template<typename T>
+    void MappedVector<T>::remap(std::size_t capacity) {
+        std::size_t new_length = HEADER_SIZE + capacity * sizeof(T);
+        if (::ftruncate(fd, static_cast<off_t>(new_length)) != 0) fail("Cannot resize the MappedVector file");
+#ifdef __linux__
+        // the pages stay where they are in the page cache, only the virtual range is moved if it cannot grow in place
+        void* mapped = ::mremap(region, region_length, new_length, MREMAP_MAYMOVE);
+        if (mapped == MAP_FAILED) fail("Cannot remap the MappedVector file");
+#else
+        ::munmap(region, region_length);
+        void* mapped = ::mmap(nullptr, new_length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            region = nullptr;
+            fail("Cannot remap the MappedVector file");
+        }
+#endif
+        region = static_cast<char*>(mapped);
+        region_length = new_length;
+        cp = capacity;
+        counter.reallocation();
+        apply_access();
+    }
+
+    template<typename T>
+    void MappedVector<T>::apply_access() noexcept {
+        int advice = access == Access::SEQUENTIAL ? MADV_SEQUENTIAL : (access == Access::RANDOM ? MADV_RANDOM : MADV_NORMAL);
+        ::madvise(region, region_length, advice);
+    }
+
+    template<typename T>
+    void MappedVector<T>::push_back(const T& element) {
+        std::size_t sz = size();
+        if (sz == cp) {
+            T copy = element; // element may live in the mapping that is about to move
+            remap(cp * 2);
+            data()[sz] = copy;
+        }
+        else data()[sz] = element;
+        set_size(sz + 1);
+        counter.copy();
+    }
+
+    template<typename T>
+    void MappedVector<T>::pop_back() {
+        if (empty()) throw std::out_of_range("mapped vector empty before pop."); // EXCEPTION
+        set_size(size() - 1);
+    }
+
+    template<typename T>
+    void MappedVector<T>::resize(std::size_t size) {
+        std::size_t sz = this->size();
+        if (size > cp) remap(std::max(size, cp * 2));
+        // shrinking leaves old values in the file, so the elements that come back are cleared
+        if (size > sz) std::memset(static_cast<void*>(data() + sz), 0, (size - sz) * sizeof(T));
+        set_size(size);
+    }
+
+    template<typename T>
+    void MappedVector<T>::reserve(std::size_t capacity) {
+        if (capacity > cp) remap(capacity);
+    }
+
+    template<typename T>
+    void MappedVector<T>::shrink_to_fit() {
+        if (cp > size()) remap(std::max<std::size_t>(size(), 1));
+    }
+
+    template<typename T>
+    T& MappedVector<T>::front() const { return data()[0]; }
+
+    template<typename T>
+    T& MappedVector<T>::back() const { return data()[size() - 1]; }
+
+    template<typename T>
+    T& MappedVector<T>::at(std::size_t index) const {
+        if (index >= size()) throw std::out_of_range("mapped vector index outside range."); // EXCEPTION
+        return data()[index];
+    }
+
+    template<typename T>
+    void MappedVector<T>::flush() {
+        if (::msync(region, HEADER_SIZE + size() * sizeof(T), MS_SYNC) != 0) fail("Cannot flush the MappedVector file");
+    }
+
+    template<typename T>
+    void MappedVector<T>::advise(Access _access) noexcept {
+        access = _access;
+        apply_access();
+    }
+}
+
+#endif // !__MAPPED_VECTOR_HPP__
\ No newline at end of file
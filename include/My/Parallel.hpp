@@ -0,0 +1,399 @@
+﻿#pragma once
+#ifndef __PARALLEL_HPP__
+#define __PARALLEL_HPP__
+
+#include <utility>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <vector>
+#include <deque>
+#include <optional>
+#include <algorithm>
+#include <numeric>
+#include <iterator>
+#include <type_traits>
+#include <cstddef>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+// Parallel algorithms over random access ranges such as My::Vector, run on a work-stealing thread pool.
+// Every algorithm takes the pool as an optional first argument, ThreadPool::global() is used without it.
+// Ranges shorter than SEQUENTIAL_THRESHOLD and pools of one thread run the sequential std:: algorithm.
+namespace My {
+    namespace parallel {
+        inline constexpr std::size_t SEQUENTIAL_THRESHOLD = std::size_t(1) << 15;
+        inline constexpr std::size_t MIN_CHUNK = 2048;
+
+        // Every worker owns a task deque: it pushes and pops at the back, idle workers steal from the front of
+        // the others, so the oldest (largest) pieces of work move between threads and the newest stay in cache.
+        // A thread that waits for a TaskGroup runs queued tasks meanwhile, so the calling thread counts as one
+        // of the threads of the pool and nested parallelism cannot deadlock.
+        class ThreadPool {
+            struct alignas(64) Queue {
+                std::mutex lock;
+                std::deque<std::function<void()>> tasks;
+            };
+
+            std::vector<std::unique_ptr<Queue>> queues; // one per worker, the last one also takes tasks from other threads
+            std::vector<std::thread> workers;
+            std::size_t threads;
+            std::atomic<std::size_t> queued{ 0 };
+            std::atomic<std::size_t> next_queue{ 0 };
+            std::mutex sleep_lock;
+            std::condition_variable wake;
+            bool stopping = false;
+
+            inline static thread_local ThreadPool* current_pool = nullptr;
+            inline static thread_local std::size_t current_queue = 0;
+
+            void submit(std::function<void()> task) {
+                std::size_t index = current_pool == this ? current_queue : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+                {
+                    std::lock_guard<std::mutex> guard(queues[index]->lock);
+                    queues[index]->tasks.push_back(std::move(task));
+                }
+                queued.fetch_add(1);
+                { std::lock_guard<std::mutex> guard(sleep_lock); }
+                wake.notify_one();
+            }
+
+            // runs one queued task, the own queue first, returns false if there was none
+            bool try_run_one() {
+                std::function<void()> task;
+                std::size_t own = current_pool == this ? current_queue : queues.size();
+                if (own < queues.size()) {
+                    std::lock_guard<std::mutex> guard(queues[own]->lock);
+                    if (!queues[own]->tasks.empty()) {
+                        task = std::move(queues[own]->tasks.back());
+                        queues[own]->tasks.pop_back();
+                    }
+                }
+                for (std::size_t k = 0; !task && k < queues.size(); k++) {
+                    Queue& victim = *queues[(own + 1 + k) % queues.size()];
+                    std::lock_guard<std::mutex> guard(victim.lock);
+                    if (!victim.tasks.empty()) {
+                        task = std::move(victim.tasks.front());
+                        victim.tasks.pop_front();
+                    }
+                }
+                if (!task) return false;
+                queued.fetch_sub(1);
+                task();
+                return true;
+            }
+
+            void work(std::size_t index) {
+                current_pool = this;
+                current_queue = index;
+                while (true) {
+                    if (try_run_one()) continue;
+                    std::unique_lock<std::mutex> guard(sleep_lock);
+                    wake.wait(guard, [this] { return stopping || queued.load() > 0; });
+                    if (stopping && queued.load() == 0) return;
+                }
+            }
+
+            friend class TaskGroup;
+
+        public:
+            // threads includes the thread that waits for the work, so threads - 1 workers are started
+            explicit ThreadPool(std::size_t _threads = std::max(1u, std::thread::hardware_concurrency())) : threads(std::max<std::size_t>(1, _threads)) {
+                std::size_t worker_count = threads - 1;
+                for (std::size_t i = 0; i < std::max<std::size_t>(1, worker_count); i++) queues.push_back(std::make_unique<Queue>());
+                for (std::size_t i = 0; i < worker_count; i++) workers.emplace_back(&ThreadPool::work, this, i);
+            }
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+            ~ThreadPool() {
+                {
+                    std::lock_guard<std::mutex> guard(sleep_lock);
+                    stopping = true;
+                }
+                wake.notify_all();
+                for (auto& worker : workers) worker.join();
+            }
+
+            std::size_t concurrency() const noexcept { return threads; }
+
+            // the pool used when no pool is passed, one thread per hardware thread
+            static ThreadPool& global() {
+                static ThreadPool pool;
+                return pool;
+            }
+        };
+
+        // fork-join: run() queues a task, wait() returns when every task (including the ones they ran) is done
+        // and rethrows the first exception thrown by a task
+        class TaskGroup {
+            ThreadPool& pool;
+            std::atomic<std::size_t> pending{ 0 };
+            std::mutex error_lock;
+            std::exception_ptr error;
+
+            void wait_all() noexcept {
+                while (pending.load() != 0) {
+                    if (!pool.try_run_one()) std::this_thread::yield();
+                }
+            }
+
+        public:
+            explicit TaskGroup(ThreadPool& _pool) : pool(_pool) {}
+            TaskGroup(const TaskGroup&) = delete;
+            TaskGroup& operator=(const TaskGroup&) = delete;
+            ~TaskGroup() { wait_all(); }
+
+            template<typename Function>
+            void run(Function f) {
+                pending.fetch_add(1);
+                try {
+                    pool.submit([this, f = std::move(f)]() mutable {
+                        try {
+                            f();
+                        }
+                        catch (...) {
+                            std::lock_guard<std::mutex> guard(error_lock);
+                            if (!error) error = std::current_exception();
+                        }
+                        pending.fetch_sub(1);
+                    });
+                }
+                catch (...) {
+                    pending.fetch_sub(1);
+                    throw;
+                }
+            }
+
+            void wait() {
+                wait_all();
+                if (error) std::rethrow_exception(std::exchange(error, nullptr));
+            }
+        };
+
+        namespace ParallelDetail {
+            template<typename It, typename = void>
+            struct is_random_access : std::false_type {};
+            template<typename It>
+            struct is_random_access<It, std::void_t<typename std::iterator_traits<It>::iterator_category>>
+                : std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<It>::iterator_category> {};
+            template<typename It>
+            inline constexpr bool is_random_access_v = is_random_access<It>::value;
+
+            // the level 2 cache of one core
+            inline std::size_t cache_bytes() {
+                static const std::size_t bytes = [] {
+                    long reported = 0;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+                    reported = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+                    return reported > 0 ? static_cast<std::size_t>(reported) : std::size_t(256) * 1024;
+                }();
+                return bytes;
+            }
+
+            // a chunk takes at most half of the level 2 cache, so the data of a chunk stays in cache while it is
+            // processed, and every thread gets at least four chunks, so stealing can even out the load
+            template<typename T>
+            std::size_t chunk_size(std::size_t n, std::size_t threads) {
+                std::size_t by_cache = std::max<std::size_t>(1, cache_bytes() / 2 / sizeof(T));
+                std::size_t by_balance = (n + threads * 4 - 1) / (threads * 4);
+                return std::max(MIN_CHUNK, std::min(by_cache, by_balance));
+            }
+
+            // f(begin, end, index) for every chunk of [0, n), in parallel
+            template<typename Function>
+            void for_chunks(ThreadPool& pool, std::size_t n, std::size_t chunk, Function f) {
+                TaskGroup group(pool);
+                for (std::size_t begin = 0, index = 0; begin < n; begin += chunk, index++) {
+                    std::size_t end = std::min(n, begin + chunk);
+                    group.run([&f, begin, end, index] { f(begin, end, index); });
+                }
+                group.wait();
+            }
+
+            template<typename It>
+            It at(It first, std::size_t offset) { return first + static_cast<typename std::iterator_traits<It>::difference_type>(offset); }
+
+            // moves the merge of two sorted ranges to out; the larger range is split at its middle element and the
+            // other one at the matching position, the left halves become a new task and the right halves are continued
+            template<typename A, typename B, typename Out, typename Compare>
+            void merge(TaskGroup& group, A a, A a_last, B b, B b_last, Out out, Compare comp, std::size_t grain) {
+                while (true) {
+                    std::size_t na = static_cast<std::size_t>(a_last - a), nb = static_cast<std::size_t>(b_last - b);
+                    if (na + nb <= grain) {
+                        std::merge(std::make_move_iterator(a), std::make_move_iterator(a_last), std::make_move_iterator(b), std::make_move_iterator(b_last), out, comp);
+                        return;
+                    }
+                    A a_mid;
+                    B b_mid;
+                    Out out_mid;
+                    if (na >= nb) {
+                        a_mid = at(a, na / 2);
+                        b_mid = std::lower_bound(b, b_last, *a_mid, comp);
+                        out_mid = at(out, na / 2 + static_cast<std::size_t>(b_mid - b));
+                        *out_mid = std::move(*a_mid);
+                    }
+                    else {
+                        b_mid = at(b, nb / 2);
+                        a_mid = std::upper_bound(a, a_last, *b_mid, comp);
+                        out_mid = at(out, nb / 2 + static_cast<std::size_t>(a_mid - a));
+                        *out_mid = std::move(*b_mid);
+                    }
+                    group.run([&group, a, a_mid, b, b_mid, out, comp, grain] { ParallelDetail::merge(group, a, a_mid, b, b_mid, out, comp, grain); });
+                    if (na >= nb) a = at(a_mid, 1), b = b_mid;
+                    else a = a_mid, b = at(b_mid, 1);
+                    out = at(out_mid, 1);
+                }
+            }
+        }
+
+        // calls f for every element, possibly from several threads at once
+        template<typename It, typename Function, std::enable_if_t<ParallelDetail::is_random_access_v<It>, int> = 0>
+        void for_each(ThreadPool& pool, It first, It last, Function f) {
+            using T = typename std::iterator_traits<It>::value_type;
+            std::size_t n = static_cast<std::size_t>(last - first);
+            if (n < SEQUENTIAL_THRESHOLD || pool.concurrency() == 1) {
+                std::for_each(first, last, f);
+                return;
+            }
+            ParallelDetail::for_chunks(pool, n, ParallelDetail::chunk_size<T>(n, pool.concurrency()), [&](std::size_t begin, std::size_t end, std::size_t) {
+                std::for_each(ParallelDetail::at(first, begin), ParallelDetail::at(first, end), f);
+            });
+        }
+
+        // d_first may be first
+        template<typename It, typename OutIt, typename UnaryOp, std::enable_if_t<ParallelDetail::is_random_access_v<It>, int> = 0>
+        OutIt transform(ThreadPool& pool, It first, It last, OutIt d_first, UnaryOp op) {
+            using T = typename std::iterator_traits<It>::value_type;
+            std::size_t n = static_cast<std::size_t>(last - first);
+            if (n < SEQUENTIAL_THRESHOLD || pool.concurrency() == 1) return std::transform(first, last, d_first, op);
+            ParallelDetail::for_chunks(pool, n, ParallelDetail::chunk_size<T>(n, pool.concurrency()), [&](std::size_t begin, std::size_t end, std::size_t) {
+                std::transform(ParallelDetail::at(first, begin), ParallelDetail::at(first, end), ParallelDetail::at(d_first, begin), op);
+            });
+            return ParallelDetail::at(d_first, n);
+        }
+
+        // op must be associative, the elements are combined in their order, so it need not be commutative
+        template<typename It, typename T, typename BinaryOp = std::plus<>, std::enable_if_t<ParallelDetail::is_random_access_v<It>, int> = 0>
+        T reduce(ThreadPool& pool, It first, It last, T init, BinaryOp op = BinaryOp()) {
+            using Value = typename std::iterator_traits<It>::value_type;
+            std::size_t n = static_cast<std::size_t>(last - first);
+            if (n < SEQUENTIAL_THRESHOLD || pool.concurrency() == 1) return std::accumulate(first, last, std::move(init), op);
+
+            std::size_t chunk = ParallelDetail::chunk_size<Value>(n, pool.concurrency());
+            std::vector<std::optional<T>> partial((n + chunk - 1) / chunk);
+            ParallelDetail::for_chunks(pool, n, chunk, [&](std::size_t begin, std::size_t end, std::size_t index) {
+                T sum = *ParallelDetail::at(first, begin);
+                for (It cur = ParallelDetail::at(first, begin + 1), stop = ParallelDetail::at(first, end); cur != stop; ++cur) sum = op(std::move(sum), *cur);
+                partial[index].emplace(std::move(sum));
+            });
+            for (auto& sum : partial) init = op(std::move(init), std::move(*sum));
+            return init;
+        }
+
+        // d_first[i] = first[0] op ... op first[i]; one pass sums the chunks, a second one scans every chunk from
+        // the sum of the chunks before it; d_first may be first
+        template<typename It, typename OutIt, typename BinaryOp = std::plus<>, std::enable_if_t<ParallelDetail::is_random_access_v<It>, int> = 0>
+        OutIt inclusive_scan(ThreadPool& pool, It first, It last, OutIt d_first, BinaryOp op = BinaryOp()) {
+            using Value = typename std::iterator_traits<It>::value_type;
+            std::size_t n = static_cast<std::size_t>(last - first);
+            if (n < SEQUENTIAL_THRESHOLD || pool.concurrency() == 1) return std::inclusive_scan(first, last, d_first, op);
+
+            std::size_t chunk = ParallelDetail::chunk_size<Value>(n, pool.concurrency());
+            std::vector<std::optional<Value>> carry((n + chunk - 1) / chunk);
+            ParallelDetail::for_chunks(pool, n, chunk, [&](std::size_t begin, std::size_t end, std::size_t index) {
+                if (index + 1 == carry.size()) return; // nothing comes after the last chunk
+                Value sum = *ParallelDetail::at(first, begin);
+                for (It cur = ParallelDetail::at(first, begin + 1), stop = ParallelDetail::at(first, end); cur != stop; ++cur) sum = op(std::move(sum), *cur);
+                carry[index].emplace(std::move(sum));
+            });
+            // carry[i] becomes the sum of the chunks 0 .. i
+            for (std::size_t i = 1; i + 1 < carry.size(); i++) carry[i].emplace(op(*carry[i - 1], std::move(*carry[i])));
+            ParallelDetail::for_chunks(pool, n, chunk, [&](std::size_t begin, std::size_t end, std::size_t index) {
+                if (index == 0) {
+                    std::inclusive_scan(first, ParallelDetail::at(first, end), d_first, op);
+                    return;
+                }
+                Value sum = *carry[index - 1];
+                OutIt out = ParallelDetail::at(d_first, begin);
+                for (It cur = ParallelDetail::at(first, begin), stop = ParallelDetail::at(first, end); cur != stop; ++cur, ++out) {
+                    sum = op(std::move(sum), *cur);
+                    *out = sum;
+                }
+            });
+            return ParallelDetail::at(d_first, n);
+        }
+
+        // not stable, like std::sort: the chunks are sorted in parallel and then merged pairwise, every merge is split
+        // into parallel tasks as well; needs a buffer of n elements
+        template<typename It, typename Compare = std::less<>, std::enable_if_t<ParallelDetail::is_random_access_v<It>, int> = 0>
+        void sort(ThreadPool& pool, It first, It last, Compare comp = Compare()) {
+            using T = typename std::iterator_traits<It>::value_type;
+            std::size_t n = static_cast<std::size_t>(last - first);
+            if constexpr (!std::is_default_constructible_v<T>) {
+                std::sort(first, last, comp);
+            }
+            else {
+                if (n < SEQUENTIAL_THRESHOLD || pool.concurrency() == 1) {
+                    std::sort(first, last, comp);
+                    return;
+                }
+                std::size_t chunk = ParallelDetail::chunk_size<T>(n, pool.concurrency());
+                ParallelDetail::for_chunks(pool, n, chunk, [&](std::size_t begin, std::size_t end, std::size_t) {
+                    std::sort(ParallelDetail::at(first, begin), ParallelDetail::at(first, end), comp);
+                });
+
+                std::unique_ptr<T[]> buffer(new T[n]);
+                bool in_buffer = false; // where the sorted runs are
+                for (std::size_t width = chunk; width < n; width *= 2) {
+                    TaskGroup group(pool);
+                    for (std::size_t lo = 0; lo < n; lo += 2 * width) {
+                        std::size_t mid = std::min(n, lo + width), hi = std::min(n, lo + 2 * width);
+                        if (in_buffer) {
+                            T* source = buffer.get();
+                            group.run([&group, source, first, lo, mid, hi, comp, chunk] {
+                                ParallelDetail::merge(group, source + lo, source + mid, source + mid, source + hi, ParallelDetail::at(first, lo), comp, chunk);
+                            });
+                        }
+                        else {
+                            T* target = buffer.get();
+                            group.run([&group, target, first, lo, mid, hi, comp, chunk] {
+                                ParallelDetail::merge(group, ParallelDetail::at(first, lo), ParallelDetail::at(first, mid), ParallelDetail::at(first, mid), ParallelDetail::at(first, hi), target + lo, comp, chunk);
+                            });
+                        }
+                    }
+                    group.wait();
+                    in_buffer = !in_buffer;
+                }
+                if (in_buffer) {
+                    ParallelDetail::for_chunks(pool, n, chunk, [&](std::size_t begin, std::size_t end, std::size_t) {
+                        std::move(buffer.get() + begin, buffer.get() + end, ParallelDetail::at(first, begin));
+                    });
+                }
+            }
+        }
+
+        // the same algorithms on ThreadPool::global()
+        template<typename It, typename Function, std::enable_if_t<ParallelDetail::is_random_access_v<It>, int> = 0>
+        void for_each(It first, It last, Function f) { parallel::for_each(ThreadPool::global(), first, last, std::move(f)); }
+
+        template<typename It, typename OutIt, typename UnaryOp, std::enable_if_t<ParallelDetail::is_random_access_v<It>, int> = 0>
+        OutIt transform(It first, It last, OutIt d_first, UnaryOp op) { return parallel::transform(ThreadPool::global(), first, last, d_first, std::move(op)); }
+
+        template<typename It, typename T, typename BinaryOp = std::plus<>, std::enable_if_t<ParallelDetail::is_random_access_v<It>, int> = 0>
+        T reduce(It first, It last, T init, BinaryOp op = BinaryOp()) { return parallel::reduce(ThreadPool::global(), first, last, std::move(init), std::move(op)); }
+
+        template<typename It, typename OutIt, typename BinaryOp = std::plus<>, std::enable_if_t<ParallelDetail::is_random_access_v<It>, int> = 0>
+        OutIt inclusive_scan(It first, It last, OutIt d_first, BinaryOp op = BinaryOp()) { return parallel::inclusive_scan(ThreadPool::global(), first, last, d_first, std::move(op)); }
+
+        template<typename It, typename Compare = std::less<>, std::enable_if_t<ParallelDetail::is_random_access_v<It>, int> = 0>
+        void sort(It first, It last, Compare comp = Compare()) { parallel::sort(ThreadPool::global(), first, last, std::move(comp)); }
+    }
+}
+
+#endif // !__PARALLEL_HPP__
\ No newline at end of file
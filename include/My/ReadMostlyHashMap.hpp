@@ -0,0 +1,272 @@
+﻿#pragma once
+#ifndef __READ_MOSTLY_HASHMAP_HPP__
+#define __READ_MOSTLY_HASHMAP_HPP__
+
+#include <atomic>
+#include <utility>
+#include <functional>
+#include <cstddef>
+#include "Reclamation.hpp"
+
+namespace My {
+    // HashMap for one writer and many readers: readers never take a lock and never wait for the writer.
+    // The table is the same open addressing table as in HashMap, but every bucket is an atomic pointer to an immutable node,
+    // so the writer replaces a node instead of changing it, and rehash() builds a new table and swaps it in (RCU).
+    // Replaced nodes and old tables are reclaimed through Epoch once no reader can see them.
+    // Only one thread at a time may call the writer methods (insert, erase, clear, rehash),
+    // the reader methods (find, count, for_each, size) may be called from any thread at any time.
+    template <typename T1, typename T2, typename Hash = std::hash<T1>>
+    class ReadMostlyHashMap {
+    private:
+        const std::size_t DEFAULT_NUMBER_OF_BUCKETS = 8;
+        const std::size_t FACTOR_OF_REHASHING = 2;
+        const float REHASHING_COEFFICIENT = 0.7f;
+
+        struct Node {
+            const T1 key;
+            const T2 value;
+        };
+
+        struct Table {
+            std::size_t number_of_buckets;
+            std::atomic<Node*>* buckets; // nullptr is an absent bucket, tombstone() a deleted one
+
+            explicit Table(std::size_t _number_of_buckets) : number_of_buckets(_number_of_buckets), buckets(new std::atomic<Node*>[_number_of_buckets]) {
+                for (std::size_t i = 0; i < number_of_buckets; i++) buckets[i].store(nullptr, std::memory_order_relaxed);
+            }
+            ~Table() { delete[] buckets; }
+        };
+
+        std::atomic<Table*> table;
+        std::atomic<std::size_t> sz;
+        std::size_t buckets_used; // present and deleted buckets, touched only by the writer
+        Hash hash;
+
+        alignas(Node) static inline unsigned char tombstone_storage[sizeof(Node)] = {};
+        static Node* tombstone() noexcept { return reinterpret_cast<Node*>(tombstone_storage); }
+
+        static void reclaim_node(void* node) { delete static_cast<Node*>(node); }
+        static void reclaim_table(void* old_table) { delete static_cast<Table*>(old_table); }
+        static void reclaim_table_and_nodes(void* old_table);
+
+        // bucket of the key or number_of_buckets if it is absent
+        std::size_t find_index(const Table& current, const T1& key) const;
+        // the node a reader matched, the bucket may already hold another node or a tombstone when it is used
+        Node* find_node(const Table& current, const T1& key) const;
+        void place(Table& target, Node* node) const; // the key must be absent from target
+
+    public:
+        ReadMostlyHashMap(const Hash& _hash = Hash());
+        ReadMostlyHashMap(int size, const Hash& _hash = Hash());
+        ReadMostlyHashMap(const ReadMostlyHashMap&) = delete;
+        ReadMostlyHashMap& operator= (const ReadMostlyHashMap&) = delete;
+
+        ~ReadMostlyHashMap(); // no reader may use the map anymore
+
+        // writer
+        void insert(const T1& key, const T2& value); // assigns the value if the key is present, like HashMap::insert
+        void insert(std::pair<T1, T2> pair_key_value) { insert(pair_key_value.first, pair_key_value.second); }
+        bool erase(const T1& key); // false if the key was absent
+        void clear();
+        void rehash(); // the new table has FACTOR_OF_REHASHING times more buckets unless it is mostly deleted buckets
+
+        // readers
+        bool find(const T1& key, T2& value) const; // copies the value out, false if the key is absent
+        bool count(const T1& key) const;
+        template<typename Function>
+        void for_each(Function f) const; // calls f(key, value) for every element of the table that was current at the call
+        std::size_t size() const noexcept { return sz.load(std::memory_order_relaxed); }
+        bool empty() const noexcept { return size() == 0; }
+        std::size_t bucket_count() const noexcept { return table.load(std::memory_order_acquire)->number_of_buckets; }
+    };
+
+    template <typename T1, typename T2, typename Hash>
+    ReadMostlyHashMap<T1, T2, Hash>::ReadMostlyHashMap(const Hash& _hash) : table(new Table(DEFAULT_NUMBER_OF_BUCKETS)), sz(0), buckets_used(0), hash(_hash) {}
+
+    template <typename T1, typename T2, typename Hash>
+    ReadMostlyHashMap<T1, T2, Hash>::ReadMostlyHashMap(int size, const Hash& _hash) : sz(0), buckets_used(0), hash(_hash) {
+        if (size <= 0) throw std::length_error("Table size must be greater then 0."); // EXCEPTION
+        table.store(new Table(size), std::memory_order_relaxed);
+    }
+
+    template <typename T1, typename T2, typename Hash>
+    ReadMostlyHashMap<T1, T2, Hash>::~ReadMostlyHashMap() {
+        reclaim_table_and_nodes(table.load(std::memory_order_relaxed));
+    }
+
+    template <typename T1, typename T2, typename Hash>
+    void ReadMostlyHashMap<T1, T2, Hash>::reclaim_table_and_nodes(void* old_table) {
+        Table* current = static_cast<Table*>(old_table);
+        for (std::size_t i = 0; i < current->number_of_buckets; i++) {
+            Node* node = current->buckets[i].load(std::memory_order_relaxed);
+            if (node && node != tombstone()) delete node;
+        }
+        delete current;
+    }
+
+    template <typename T1, typename T2, typename Hash>
+    std::size_t ReadMostlyHashMap<T1, T2, Hash>::find_index(const Table& current, const T1& key) const {
+        std::size_t index = hash(key) % current.number_of_buckets;
+        for (std::size_t probes = 0; probes < current.number_of_buckets; probes++) {
+            Node* node = current.buckets[index].load(std::memory_order_acquire);
+            if (!node) break;
+            if (node != tombstone() && node->key == key) return index;
+            index++;
+            if (index >= current.number_of_buckets) {
+                index = 0;
+            }
+        }
+        return current.number_of_buckets;
+    }
+
+    template <typename T1, typename T2, typename Hash>
+    typename ReadMostlyHashMap<T1, T2, Hash>::Node* ReadMostlyHashMap<T1, T2, Hash>::find_node(const Table& current, const T1& key) const {
+        std::size_t index = hash(key) % current.number_of_buckets;
+        for (std::size_t probes = 0; probes < current.number_of_buckets; probes++) {
+            Node* node = current.buckets[index].load(std::memory_order_acquire);
+            if (!node) break;
+            if (node != tombstone() && node->key == key) return node;
+            index++;
+            if (index >= current.number_of_buckets) {
+                index = 0;
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename T1, typename T2, typename Hash>
+    void ReadMostlyHashMap<T1, T2, Hash>::place(Table& target, Node* node) const {
+        // deleted buckets are not reused, so a reader never meets the key twice in one chain
+        std::size_t index = hash(node->key) % target.number_of_buckets;
+        while (target.buckets[index].load(std::memory_order_relaxed)) {
+            index++;
+            if (index >= target.number_of_buckets) {
+                index = 0;
+            }
+        }
+        target.buckets[index].store(node, std::memory_order_release);
+    }
+
+    template <typename T1, typename T2, typename Hash>
+    void ReadMostlyHashMap<T1, T2, Hash>::insert(const T1& key, const T2& value) {
+        Node* node = new Node{ key, value };
+        Table& current = *table.load(std::memory_order_relaxed);
+        std::size_t index = find_index(current, key);
+        if (index != current.number_of_buckets) {
+            Node* old = current.buckets[index].exchange(node, std::memory_order_acq_rel);
+            Epoch::retire(old, &reclaim_node);
+            return;
+        }
+
+        place(current, node);
+        buckets_used++;
+        sz.fetch_add(1, std::memory_order_relaxed);
+        if (static_cast<float>(buckets_used) / current.number_of_buckets >= REHASHING_COEFFICIENT) {
+            rehash();
+        }
+    }
+
+    template <typename T1, typename T2, typename Hash>
+    bool ReadMostlyHashMap<T1, T2, Hash>::erase(const T1& key) {
+        Table& current = *table.load(std::memory_order_relaxed);
+        std::size_t index = find_index(current, key);
+        if (index == current.number_of_buckets) return false;
+
+        Node* old = current.buckets[index].exchange(tombstone(), std::memory_order_acq_rel);
+        Epoch::retire(old, &reclaim_node);
+        sz.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    template <typename T1, typename T2, typename Hash>
+    void ReadMostlyHashMap<T1, T2, Hash>::clear() {
+        Table* old = table.exchange(new Table(DEFAULT_NUMBER_OF_BUCKETS), std::memory_order_acq_rel);
+        buckets_used = 0;
+        sz.store(0, std::memory_order_relaxed);
+        Epoch::retire(old, &reclaim_table_and_nodes);
+    }
+
+    template <typename T1, typename T2, typename Hash>
+    void ReadMostlyHashMap<T1, T2, Hash>::rehash() {
+        Table* old = table.load(std::memory_order_relaxed);
+        std::size_t present = sz.load(std::memory_order_relaxed);
+        // a table that is full mostly because of deleted buckets is only cleaned
+        std::size_t number_of_buckets = old->number_of_buckets;
+        if (static_cast<float>(present + 1) / number_of_buckets >= REHASHING_COEFFICIENT / FACTOR_OF_REHASHING) {
+            number_of_buckets *= FACTOR_OF_REHASHING;
+        }
+
+        // the nodes are moved by pointer into a table that readers cannot see until it is complete
+        Table* fresh = new Table(number_of_buckets);
+        try {
+            for (std::size_t i = 0; i < old->number_of_buckets; i++) {
+                Node* node = old->buckets[i].load(std::memory_order_relaxed);
+                if (node && node != tombstone()) place(*fresh, node);
+            }
+        }
+        catch (...) {
+            delete fresh;
+            throw;
+        }
+
+        buckets_used = present;
+        table.store(fresh, std::memory_order_release);
+        Epoch::retire(old, &reclaim_table);
+    }
+
+    template <typename T1, typename T2, typename Hash>
+    bool ReadMostlyHashMap<T1, T2, Hash>::find(const T1& key, T2& value) const {
+        Epoch::Guard guard;
+        const Table& current = *table.load(std::memory_order_acquire);
+        // the value comes from the node that matched, the guard keeps it alive even if the writer replaces or erases it meanwhile
+        Node* node = find_node(current, key);
+        if (!node) return false;
+        value = node->value;
+        return true;
+    }
+
+    template <typename T1, typename T2, typename Hash>
+    bool ReadMostlyHashMap<T1, T2, Hash>::count(const T1& key) const {
+        Epoch::Guard guard;
+        const Table& current = *table.load(std::memory_order_acquire);
+        return find_node(current, key) != nullptr;
+    }
+
+    template <typename T1, typename T2, typename Hash>
+    template<typename Function>
+    void ReadMostlyHashMap<T1, T2, Hash>::for_each(Function f) const {
+        Epoch::Guard guard;
+        const Table& current = *table.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < current.number_of_buckets; i++) {
+            Node* node = current.buckets[i].load(std::memory_order_acquire);
+            if (node && node != tombstone()) f(node->key, node->value);
+        }
+    }
+
+    // HashSet for one writer and many readers, the same table as ReadMostlyHashMap with nothing stored next to the key
+    template <typename T, typename Hash = std::hash<T>>
+    class ReadMostlyHashSet {
+        struct Empty {};
+        ReadMostlyHashMap<T, Empty, Hash> set;
+
+    public:
+        ReadMostlyHashSet(const Hash& _hash = Hash()) : set(_hash) {}
+        ReadMostlyHashSet(int size, const Hash& _hash = Hash()) : set(size, _hash) {}
+
+        // writer
+        void insert(const T& key) { if (!set.count(key)) set.insert(key, Empty()); }
+        bool erase(const T& key) { return set.erase(key); }
+        void clear() { set.clear(); }
+        void rehash() { set.rehash(); }
+
+        // readers
+        bool count(const T& key) const { return set.count(key); }
+        template<typename Function>
+        void for_each(Function f) const { set.for_each([&f](const T& key, const Empty&) { f(key); }); }
+        std::size_t size() const noexcept { return set.size(); }
+        bool empty() const noexcept { return set.empty(); }
+        std::size_t bucket_count() const noexcept { return set.bucket_count(); }
+    };
+}
+
+#endif // !__READ_MOSTLY_HASHMAP_HPP__
\ No newline at end of file
@@ -0,0 +1,345 @@
+﻿#pragma once
+#ifndef __RECLAMATION_HPP__
+#define __RECLAMATION_HPP__
+
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+// Memory reclamation for the lock-free containers: a node that was unlinked by one thread
+// may still be read by another one, so it is handed back only when nobody can reach it anymore.
+namespace My {
+    // Hazard pointers: a reader publishes the pointer it is about to dereference in one of its slots,
+    // a retired pointer is reclaimed only when no slot of any thread holds it.
+    // There is one process-wide domain, every thread owns one record that is returned to the registry at thread exit.
+    class HazardPointers {
+    public:
+        static constexpr std::size_t slots_per_thread = 2;
+
+    private:
+        struct Retired {
+            void* ptr;
+            void (*reclaim)(void*);
+        };
+
+        struct alignas(64) Record {
+            std::atomic<void*> hazards[slots_per_thread] = {};
+            std::atomic<bool> active{ true };
+            Record* next = nullptr; // the registry only grows, so next never changes after the record is published
+            std::vector<Retired> retired; // touched only by the owner of the record
+        };
+
+        struct LocalHandle {
+            Record* record = nullptr;
+            ~LocalHandle();
+        };
+
+        std::atomic<Record*> head{ nullptr };
+        std::atomic<std::size_t> record_count{ 0 };
+
+        static HazardPointers& domain() {
+            static HazardPointers* instance = new HazardPointers(); // never destroyed, threads may exit after static destruction
+            return *instance;
+        }
+
+        static Record& local() {
+            thread_local LocalHandle handle;
+            if (!handle.record) handle.record = domain().acquire_record();
+            return *handle.record;
+        }
+
+        Record* acquire_record();
+        void scan(Record& record);
+
+    public:
+        // loads source and publishes it in slot until the published value is still the current one
+        template<typename T>
+        static T* protect(std::size_t slot, const std::atomic<T*>& source) {
+            std::atomic<void*>& hazard = local().hazards[slot];
+            T* ptr = source.load();
+            while (true) {
+                hazard.store(ptr);
+                T* check = source.load();
+                if (check == ptr) return ptr;
+                ptr = check;
+            }
+        }
+
+        static void clear(std::size_t slot) { local().hazards[slot].store(nullptr, std::memory_order_release); }
+
+        // ptr must already be unreachable for new readers, reclaim(ptr) is called once no slot holds it
+        static void retire(void* ptr, void (*reclaim)(void*));
+    };
+
+    inline HazardPointers::LocalHandle::~LocalHandle() {
+        if (!record) return;
+        for (auto& hazard : record->hazards) hazard.store(nullptr);
+        // no scan here: reclaiming may touch thread_local caches that are already destroyed,
+        // so the retired pointers stay in the record and are scanned by its next owner
+        record->active.store(false, std::memory_order_release);
+    }
+
+    inline HazardPointers::Record* HazardPointers::acquire_record() {
+        for (Record* cur = head.load(std::memory_order_acquire); cur; cur = cur->next) {
+            bool expected = false;
+            if (!cur->active.load(std::memory_order_relaxed) && cur->active.compare_exchange_strong(expected, true, std::memory_order_acquire)) return cur;
+        }
+
+        Record* record = new Record();
+        Record* old_head = head.load(std::memory_order_relaxed);
+        do {
+            record->next = old_head;
+        } while (!head.compare_exchange_weak(old_head, record, std::memory_order_release, std::memory_order_relaxed));
+        record_count.fetch_add(1, std::memory_order_relaxed);
+        return record;
+    }
+
+    inline void HazardPointers::scan(Record& record) {
+        std::vector<void*> protected_ptrs;
+        protected_ptrs.reserve(record_count.load(std::memory_order_relaxed) * slots_per_thread);
+        for (Record* cur = head.load(std::memory_order_acquire); cur; cur = cur->next) {
+            for (auto& hazard : cur->hazards) {
+                if (void* ptr = hazard.load()) protected_ptrs.push_back(ptr);
+            }
+        }
+        std::sort(protected_ptrs.begin(), protected_ptrs.end());
+
+        std::vector<Retired> still_protected;
+        for (auto& retired : record.retired) {
+            if (std::binary_search(protected_ptrs.begin(), protected_ptrs.end(), retired.ptr)) still_protected.push_back(retired);
+            else retired.reclaim(retired.ptr);
+        }
+        record.retired.swap(still_protected);
+    }
+
+    inline void HazardPointers::retire(void* ptr, void (*reclaim)(void*)) {
+        Record& record = local();
+        record.retired.push_back({ ptr, reclaim });
+        // the threshold grows with the number of threads, so a scan reclaims at least half of the list on average
+        if (record.retired.size() >= 2 * slots_per_thread * domain().record_count.load(std::memory_order_relaxed) + 16) domain().scan(record);
+    }
+
+    // Epoch-based reclamation: a reader announces the global epoch while it is inside a Guard,
+    // a pointer retired in epoch e is reclaimed once the global epoch reaches e + 2, which needs every reader of epoch e to leave.
+    // Readers pay two stores per Guard and never wait, the retiring thread advances the epoch and reclaims.
+    // Like HazardPointers there is one process-wide domain and every thread owns one record.
+    class Epoch {
+        struct Retired {
+            void* ptr;
+            void (*reclaim)(void*);
+            std::uint64_t epoch;
+        };
+
+        struct alignas(64) Record {
+            std::atomic<std::uint64_t> epoch{ 0 }; // 0 outside of any Guard
+            std::atomic<bool> active{ true };
+            Record* next = nullptr; // the registry only grows, so next never changes after the record is published
+            std::size_t depth = 0; // nested Guards of the owner
+            std::vector<Retired> retired; // touched only by the owner of the record, sorted by epoch
+        };
+
+        struct LocalHandle {
+            Record* record = nullptr;
+            ~LocalHandle();
+        };
+
+        static constexpr std::size_t advance_threshold = 64;
+
+        std::atomic<std::uint64_t> global{ 1 };
+        std::atomic<Record*> head{ nullptr };
+
+        static Epoch& domain() {
+            static Epoch* instance = new Epoch(); // never destroyed, threads may exit after static destruction
+            return *instance;
+        }
+
+        static Record& local() {
+            thread_local LocalHandle handle;
+            if (!handle.record) handle.record = domain().acquire_record();
+            return *handle.record;
+        }
+
+        Record* acquire_record();
+        bool try_advance();
+        void reclaim(Record& record);
+
+    public:
+        // pointers loaded inside a Guard stay valid until the Guard is destroyed, Guards may be nested
+        class Guard {
+            Record& record;
+        public:
+            Guard();
+            ~Guard();
+            Guard(const Guard&) = delete;
+            Guard& operator= (const Guard&) = delete;
+        };
+
+        // ptr must already be unreachable for new readers, reclaim(ptr) is called once every reader that could see it has left its Guard
+        static void retire(void* ptr, void (*reclaim)(void*));
+    };
+
+    inline Epoch::LocalHandle::~LocalHandle() {
+        if (!record) return;
+        // no reclaim here for the same reason as in HazardPointers, the next owner of the record reclaims its list
+        record->depth = 0;
+        record->epoch.store(0);
+        record->active.store(false, std::memory_order_release);
+    }
+
+    inline Epoch::Record* Epoch::acquire_record() {
+        for (Record* cur = head.load(std::memory_order_acquire); cur; cur = cur->next) {
+            bool expected = false;
+            if (!cur->active.load(std::memory_order_relaxed) && cur->active.compare_exchange_strong(expected, true, std::memory_order_acquire)) return cur;
+        }
+
+        Record* record = new Record();
+        Record* old_head = head.load(std::memory_order_relaxed);
+        do {
+            record->next = old_head;
+        } while (!head.compare_exchange_weak(old_head, record, std::memory_order_release, std::memory_order_relaxed));
+        return record;
+    }
+
+    inline Epoch::Guard::Guard() : record(local()) {
+        if (record.depth++) return;
+        // announce the epoch and check that it did not move meanwhile, otherwise a retiring thread may have missed the announcement
+        std::atomic<std::uint64_t>& global = domain().global;
+        std::uint64_t epoch = global.load();
+        while (true) {
+            record.epoch.store(epoch);
+            std::uint64_t check = global.load();
+            if (check == epoch) break;
+            epoch = check;
+        }
+    }
+
+    inline Epoch::Guard::~Guard() {
+        if (--record.depth) return;
+        record.epoch.store(0, std::memory_order_release);
+    }
+
+    inline bool Epoch::try_advance() {
+        std::uint64_t epoch = global.load();
+        for (Record* cur = head.load(std::memory_order_acquire); cur; cur = cur->next) {
+            std::uint64_t announced = cur->epoch.load();
+            if (announced != 0 && announced != epoch) return false; // a reader of the previous epoch is still inside its Guard
+        }
+        return global.compare_exchange_strong(epoch, epoch + 1);
+    }
+
+    inline void Epoch::reclaim(Record& record) {
+        std::uint64_t epoch = global.load();
+        std::size_t done = 0;
+        while (done < record.retired.size() && record.retired[done].epoch + 2 <= epoch) done++;
+        // the reclaimed entries are removed before the calls, so a reclaim function that retires again does not see them
+        std::vector<Retired> ready(record.retired.begin(), record.retired.begin() + done);
+        record.retired.erase(record.retired.begin(), record.retired.begin() + done);
+        for (auto& retired : ready) retired.reclaim(retired.ptr);
+    }
+
+    inline void Epoch::retire(void* ptr, void (*reclaim)(void*)) {
+        Record& record = local();
+        Epoch& epochs = domain();
+        record.retired.push_back({ ptr, reclaim, epochs.global.load() });
+        if (record.retired.size() % advance_threshold == 0) {
+            epochs.try_advance();
+            epochs.reclaim(record);
+        }
+    }
+
+    // Fixed-size blocks for the nodes of lock-free containers.
+    // Every thread keeps a small cache, full batches are exchanged with a shared stack under a mutex,
+    // so the mutex is taken once per batch_size allocations. Full batches are kept for reuse for the lifetime of the process.
+    template<std::size_t Size, std::size_t Align>
+    class ConcurrentNodePool {
+        static constexpr std::size_t batch_size = 64;
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        struct Shared {
+            std::mutex mutex;
+            std::vector<FreeBlock*> batches; // every entry is a chain of batch_size blocks
+        };
+
+        struct LocalCache {
+            FreeBlock* head = nullptr;
+            std::size_t count = 0;
+            ~LocalCache() {
+                while (count >= batch_size) give_batch(*this);
+                // the rest is too small for a batch, it goes back to the system
+                while (head) {
+                    FreeBlock* forward = head->next;
+                    free_block(head);
+                    head = forward;
+                }
+            }
+        };
+
+        static Shared& shared() {
+            static Shared* instance = new Shared(); // never destroyed, thread caches may be flushed after static destruction
+            return *instance;
+        }
+
+        static LocalCache& cache() {
+            thread_local LocalCache local;
+            return local;
+        }
+
+        static void free_block(void* block) noexcept {
+            if constexpr (Align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(block, std::align_val_t(Align));
+            else ::operator delete(block);
+        }
+
+        static void give_batch(LocalCache& local) {
+            FreeBlock* first = local.head;
+            FreeBlock* last = first;
+            for (std::size_t i = 1; i < batch_size; i++) last = last->next;
+            local.head = last->next;
+            local.count -= batch_size;
+            last->next = nullptr;
+
+            std::lock_guard<std::mutex> lock(shared().mutex);
+            shared().batches.push_back(first);
+        }
+
+    public:
+        static void* allocate() {
+            LocalCache& local = cache();
+            if (!local.head) {
+                Shared& pool = shared();
+                std::unique_lock<std::mutex> lock(pool.mutex);
+                if (!pool.batches.empty()) {
+                    local.head = pool.batches.back();
+                    local.count = batch_size;
+                    pool.batches.pop_back();
+                }
+                else {
+                    lock.unlock();
+                    if constexpr (Align > __STDCPP_DEFAULT_NEW_ALIGNMENT__) return ::operator new(Size, std::align_val_t(Align));
+                    else return ::operator new(Size);
+                }
+            }
+
+            FreeBlock* block = local.head;
+            local.head = block->next;
+            local.count--;
+            return block;
+        }
+
+        static void deallocate(void* block) {
+            static_assert(Size >= sizeof(FreeBlock), "the pool stores its free list inside the blocks");
+            LocalCache& local = cache();
+            local.head = ::new (block) FreeBlock{ local.head };
+            local.count++;
+            if (local.count >= 2 * batch_size) give_batch(local);
+        }
+    };
+}
+
+#endif // !__RECLAMATION_HPP__
\ No newline at end of file
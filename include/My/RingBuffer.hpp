@@ -0,0 +1,286 @@
+﻿#pragma once
+#ifndef __RING_BUFFER_HPP__
+#define __RING_BUFFER_HPP__
+
+#include <utility>
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <cstdint>
+#include <thread>
+#include "Vector.hpp"
+
+namespace My {
+    enum class RingMode {
+        SPSC, // one producer thread and one consumer thread, every operation is wait-free
+        MPMC // any number of producers and consumers, per-slot sequence numbers
+    };
+
+    // bounded queue on a power-of-two ring of slots stored in a My::Vector
+    template <typename T, RingMode Mode = RingMode::SPSC>
+    class RingBuffer {
+        struct PlainSlot {
+            alignas(T) unsigned char storage[sizeof(T)];
+            T* value() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+        };
+        // sequence == position: free for the push with that position, sequence == position + 1: holds its value
+        struct SequencedSlot : PlainSlot {
+            std::atomic<std::size_t> sequence;
+        };
+        using Slot = std::conditional_t<Mode == RingMode::MPMC, SequencedSlot, PlainSlot>;
+        static_assert(Mode == RingMode::SPSC || std::is_nothrow_move_constructible_v<T>, "MPMC mode fills claimed slots by moving, the move must not throw");
+
+        // positions grow without bound, the slot of a position is position & mask
+        // each side owns a cache line, in SPSC mode it also caches the last seen position of the other side
+        struct alignas(64) Side {
+            std::atomic<std::size_t> position{ 0 };
+            std::size_t cached_other = 0;
+        };
+
+        Vector<Slot> slots;
+        Slot* ring;
+        std::size_t mask;
+        Side consumer; // head
+        Side producer; // tail
+
+        static std::size_t round_up(std::size_t capacity);
+        template<typename... Args>
+        bool emplace_spsc(Args&&... args);
+        template<typename... Args>
+        bool emplace_mpmc(Args&&... args);
+        bool pop_spsc(T& element);
+        bool pop_mpmc(T& element);
+
+    public:
+        RingBuffer(std::size_t capacity); // rounded up to a power of two
+        RingBuffer(const RingBuffer&) = delete;
+        RingBuffer& operator= (const RingBuffer&) = delete;
+
+        ~RingBuffer(); // no other thread may use the ring anymore
+
+        bool try_push(const T& element) { return try_emplace(element); }
+        bool try_push(T&& element) { return try_emplace(std::move(element)); }
+        template<typename... Args>
+        bool try_emplace(Args&&... args); // false if the ring is full
+        bool try_pop(T& element); // false if the ring is empty
+
+        // batch operations claim up to count positions with one index update and return how many were moved
+        template<typename InputIt>
+        std::size_t push_n(InputIt first, std::size_t count);
+        template<typename OutputIt>
+        std::size_t pop_n(OutputIt out, std::size_t count);
+
+        std::size_t capacity() const noexcept { return mask + 1; }
+        std::size_t size() const noexcept; // only a snapshot while other threads push or pop
+        bool empty() const noexcept { return size() == 0; }
+    };
+
+    template<typename T, RingMode Mode>
+    std::size_t RingBuffer<T, Mode>::round_up(std::size_t capacity) {
+        if (capacity == 0 || capacity > (std::size_t(1) << 30)) throw std::length_error("ring buffer capacity out of range."); // EXCEPTION
+        std::size_t result = 1;
+        while (result < capacity) result <<= 1;
+        return result;
+    }
+
+    template<typename T, RingMode Mode>
+    RingBuffer<T, Mode>::RingBuffer(std::size_t capacity) : slots(static_cast<int>(round_up(capacity))), ring(&slots[0]), mask(slots.size() - 1) {
+        if constexpr (Mode == RingMode::MPMC) {
+            for (std::size_t i = 0; i <= mask; i++) {
+                ring[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template<typename T, RingMode Mode>
+    RingBuffer<T, Mode>::~RingBuffer() {
+        std::size_t head = consumer.position.load(std::memory_order_relaxed);
+        std::size_t tail = producer.position.load(std::memory_order_relaxed);
+        for (; head != tail; head++) {
+            ring[head & mask].value()->~T();
+        }
+    }
+
+    template<typename T, RingMode Mode>
+    template<typename... Args>
+    bool RingBuffer<T, Mode>::emplace_spsc(Args&&... args) {
+        std::size_t tail = producer.position.load(std::memory_order_relaxed);
+        if (tail - producer.cached_other > mask) {
+            producer.cached_other = consumer.position.load(std::memory_order_acquire);
+            if (tail - producer.cached_other > mask) return false;
+        }
+
+        ::new (ring[tail & mask].storage) T(std::forward<Args>(args)...);
+        producer.position.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    template<typename T, RingMode Mode>
+    template<typename... Args>
+    bool RingBuffer<T, Mode>::emplace_mpmc(Args&&... args) {
+        if constexpr (!std::is_nothrow_constructible_v<T, Args&&...>) {
+            // a claimed position has to be filled, so a constructor that may throw runs before the claim
+            T value(std::forward<Args>(args)...);
+            return emplace_mpmc(std::move(value));
+        }
+        std::size_t tail = producer.position.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &ring[tail & mask];
+            std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(tail);
+            if (diff == 0) {
+                if (producer.position.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0) return false; // the slot still holds the value pushed one lap ago
+            else tail = producer.position.load(std::memory_order_relaxed);
+        }
+
+        ::new (slot->storage) T(std::forward<Args>(args)...);
+        slot->sequence.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    template<typename T, RingMode Mode>
+    bool RingBuffer<T, Mode>::pop_spsc(T& element) {
+        std::size_t head = consumer.position.load(std::memory_order_relaxed);
+        if (head == consumer.cached_other) {
+            consumer.cached_other = producer.position.load(std::memory_order_acquire);
+            if (head == consumer.cached_other) return false;
+        }
+
+        T* value = ring[head & mask].value();
+        element = std::move(*value);
+        value->~T();
+        consumer.position.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    template<typename T, RingMode Mode>
+    bool RingBuffer<T, Mode>::pop_mpmc(T& element) {
+        std::size_t head = consumer.position.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &ring[head & mask];
+            std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(head + 1);
+            if (diff == 0) {
+                if (consumer.position.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0) return false; // nothing was pushed at this position yet
+            else head = consumer.position.load(std::memory_order_relaxed);
+        }
+
+        T* value = slot->value();
+        element = std::move(*value);
+        value->~T();
+        slot->sequence.store(head + mask + 1, std::memory_order_release); // free for the push one lap later
+        return true;
+    }
+
+    template<typename T, RingMode Mode>
+    template<typename... Args>
+    bool RingBuffer<T, Mode>::try_emplace(Args&&... args) {
+        if constexpr (Mode == RingMode::SPSC) return emplace_spsc(std::forward<Args>(args)...);
+        else return emplace_mpmc(std::forward<Args>(args)...);
+    }
+
+    template<typename T, RingMode Mode>
+    bool RingBuffer<T, Mode>::try_pop(T& element) {
+        if constexpr (Mode == RingMode::SPSC) return pop_spsc(element);
+        else return pop_mpmc(element);
+    }
+
+    template<typename T, RingMode Mode>
+    template<typename InputIt>
+    std::size_t RingBuffer<T, Mode>::push_n(InputIt first, std::size_t count) {
+        std::size_t tail = producer.position.load(std::memory_order_relaxed);
+        std::size_t claimed;
+        if constexpr (Mode == RingMode::SPSC) {
+            if (tail - producer.cached_other + count > capacity()) producer.cached_other = consumer.position.load(std::memory_order_acquire);
+            claimed = std::min(count, capacity() - (tail - producer.cached_other));
+            for (std::size_t i = 0; i < claimed; i++, ++first) {
+                try {
+                    ::new (ring[(tail + i) & mask].storage) T(*first);
+                }
+                catch (...) {
+                    producer.position.store(tail + i, std::memory_order_release);
+                    throw;
+                }
+            }
+            producer.position.store(tail + claimed, std::memory_order_release);
+        }
+        else if constexpr (!std::is_nothrow_constructible_v<T, decltype(*first)>) {
+            // claimed slots could not be filled after a throw, so such elements are pushed one by one
+            for (claimed = 0; claimed < count && try_emplace(*first); claimed++, ++first) {}
+        }
+        else {
+            // claim the longest run of free slots starting at tail, a slot that is free for its position stays free until that position is claimed
+            while (true) {
+                claimed = 0;
+                while (claimed < count && ring[(tail + claimed) & mask].sequence.load(std::memory_order_acquire) == tail + claimed) claimed++;
+                if (claimed == 0) {
+                    std::size_t sequence = ring[tail & mask].sequence.load(std::memory_order_acquire);
+                    if (static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(tail) < 0) return 0;
+                    tail = producer.position.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (producer.position.compare_exchange_weak(tail, tail + claimed, std::memory_order_relaxed)) break;
+            }
+            for (std::size_t i = 0; i < claimed; i++, ++first) {
+                Slot& slot = ring[(tail + i) & mask];
+                ::new (slot.storage) T(*first);
+                slot.sequence.store(tail + i + 1, std::memory_order_release);
+            }
+        }
+        return claimed;
+    }
+
+    template<typename T, RingMode Mode>
+    template<typename OutputIt>
+    std::size_t RingBuffer<T, Mode>::pop_n(OutputIt out, std::size_t count) {
+        std::size_t head = consumer.position.load(std::memory_order_relaxed);
+        std::size_t claimed;
+        if constexpr (Mode == RingMode::SPSC) {
+            if (consumer.cached_other - head < count) consumer.cached_other = producer.position.load(std::memory_order_acquire);
+            claimed = std::min(count, consumer.cached_other - head);
+            for (std::size_t i = 0; i < claimed; i++, ++out) {
+                T* value = ring[(head + i) & mask].value();
+                *out = std::move(*value);
+                value->~T();
+            }
+            consumer.position.store(head + claimed, std::memory_order_release);
+        }
+        else {
+            while (true) {
+                claimed = 0;
+                while (claimed < count && ring[(head + claimed) & mask].sequence.load(std::memory_order_acquire) == head + claimed + 1) claimed++;
+                if (claimed == 0) {
+                    std::size_t sequence = ring[head & mask].sequence.load(std::memory_order_acquire);
+                    if (static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(head + 1) < 0) return 0;
+                    head = consumer.position.load(std::memory_order_relaxed);
+                    continue;
+                }
+                if (consumer.position.compare_exchange_weak(head, head + claimed, std::memory_order_relaxed)) break;
+            }
+            for (std::size_t i = 0; i < claimed; i++, ++out) {
+                Slot& slot = ring[(head + i) & mask];
+                T* value = slot.value();
+                *out = std::move(*value);
+                value->~T();
+                slot.sequence.store(head + i + mask + 1, std::memory_order_release);
+            }
+        }
+        return claimed;
+    }
+
+    template<typename T, RingMode Mode>
+    std::size_t RingBuffer<T, Mode>::size() const noexcept {
+        std::size_t head = consumer.position.load(std::memory_order_acquire);
+        std::size_t tail = producer.position.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+}
+
+#endif // !__RING_BUFFER_HPP__
\ No newline at end of file
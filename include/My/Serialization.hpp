@@ -0,0 +1,236 @@
+﻿#pragma once
+#ifndef __SERIALIZATION_HPP__
+#define __SERIALIZATION_HPP__
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// The binary format of write_to() and read_from() of My::Map and My::Set:
+//   "MYTR", version, kind ('M' or 'S'), key encoding and unit size, value encoding and unit size, element count,
+//   then the elements in sorted order.
+// Integers are LEB128 varints, signed ones zigzag encoded. Integral keys are stored as the difference to the
+// previous key, so dense sorted keys take one or two bytes. Strings are a length and the characters, any other
+// trivially copyable type is stored as its raw bytes, which ties those streams to the byte order of the machine.
+namespace My {
+    namespace SerializationDetail {
+        inline constexpr char MAGIC[4] = { 'M', 'Y', 'T', 'R' };
+        inline constexpr unsigned char VERSION = 1;
+        inline constexpr std::size_t CHUNK_SIZE = std::size_t(1) << 16;
+
+        template<typename T> struct is_string : std::false_type {};
+        template<typename C, typename Traits, typename Alloc>
+        struct is_string<std::basic_string<C, Traits, Alloc>> : std::bool_constant<std::is_trivially_copyable_v<C>> {};
+
+        // stored in the header, so a stream is only read back into the types it was written from
+        enum class Encoding : unsigned char { NONE, UNSIGNED, SIGNED, STRING, RAW };
+
+        template<typename T>
+        constexpr Encoding encoding_of() {
+            if constexpr (std::is_void_v<T>) return Encoding::NONE;
+            else if constexpr (std::is_enum_v<T>) return encoding_of<std::underlying_type_t<T>>();
+            else if constexpr (std::is_integral_v<T>) return std::is_signed_v<T> ? Encoding::SIGNED : Encoding::UNSIGNED;
+            else if constexpr (is_string<T>::value) return Encoding::STRING;
+            else {
+                static_assert(std::is_trivially_copyable_v<T>, "write_to() and read_from() need integral, enum, string or trivially copyable types.");
+                return Encoding::RAW;
+            }
+        }
+
+        template<typename T>
+        constexpr std::size_t unit_size_of() {
+            if constexpr (std::is_void_v<T>) return 0;
+            else if constexpr (is_string<T>::value) return sizeof(typename T::value_type);
+            else return sizeof(T);
+        }
+
+        template<typename T>
+        constexpr bool is_integer_v = std::is_integral_v<T> || std::is_enum_v<T>;
+
+        template<typename T>
+        std::uint64_t to_bits(T value) noexcept {
+            if constexpr (std::is_enum_v<T>) return to_bits(static_cast<std::underlying_type_t<T>>(value));
+            else if constexpr (std::is_signed_v<T>) return static_cast<std::uint64_t>(static_cast<std::int64_t>(value));
+            else return static_cast<std::uint64_t>(value);
+        }
+
+        inline std::uint64_t zigzag(std::uint64_t bits) noexcept { return (bits << 1) ^ (0 - (bits >> 63)); }
+        inline std::uint64_t unzigzag(std::uint64_t code) noexcept { return (code >> 1) ^ (0 - (code & 1)); }
+
+        // collects the encoded bytes in a fixed buffer and hands it to the stream whenever it is full
+        class Writer {
+            std::ostream& out;
+            std::unique_ptr<char[]> chunk;
+            std::size_t used = 0;
+            std::uint64_t previous_key = 0;
+        public:
+            explicit Writer(std::ostream& _out) : out(_out), chunk(new char[CHUNK_SIZE]) {}
+
+            void put(char byte) {
+                if (used == CHUNK_SIZE) flush();
+                chunk[used++] = byte;
+            }
+            void put(const char* data, std::size_t n) {
+                while (n) {
+                    if (used == CHUNK_SIZE) flush();
+                    std::size_t part = std::min(n, CHUNK_SIZE - used);
+                    std::memcpy(chunk.get() + used, data, part);
+                    used += part;
+                    data += part;
+                    n -= part;
+                }
+            }
+            void put_varint(std::uint64_t value) {
+                while (value >= 0x80) {
+                    put(static_cast<char>(value | 0x80));
+                    value >>= 7;
+                }
+                put(static_cast<char>(value));
+            }
+            void flush() {
+                out.write(chunk.get(), used);
+                used = 0;
+                if (!out) throw std::runtime_error("Cannot write the stream."); // EXCEPTION
+            }
+
+            template<typename Key, typename Value>
+            void write_header(char kind, std::size_t count) {
+                put(MAGIC, sizeof(MAGIC));
+                put(static_cast<char>(VERSION));
+                put(kind);
+                put(static_cast<char>(encoding_of<Key>()));
+                put_varint(unit_size_of<Key>());
+                put(static_cast<char>(encoding_of<Value>()));
+                put_varint(unit_size_of<Value>());
+                put_varint(count);
+            }
+
+            template<typename T>
+            void write_value(const T& value) {
+                if constexpr (is_integer_v<T>) {
+                    if constexpr (encoding_of<T>() == Encoding::SIGNED) put_varint(zigzag(to_bits(value)));
+                    else put_varint(to_bits(value));
+                }
+                else if constexpr (is_string<T>::value) {
+                    put_varint(value.size());
+                    put(reinterpret_cast<const char*>(value.data()), value.size() * sizeof(typename T::value_type));
+                }
+                else {
+                    static_assert(encoding_of<T>() == Encoding::RAW);
+                    put(reinterpret_cast<const char*>(&value), sizeof(T));
+                }
+            }
+
+            // keys come in sorted order, integral ones are written as the difference to the previous key
+            template<typename T>
+            void write_key(const T& key) {
+                if constexpr (is_integer_v<T>) {
+                    std::uint64_t bits = to_bits(key);
+                    put_varint(zigzag(bits - previous_key));
+                    previous_key = bits;
+                }
+                else write_value(key);
+            }
+        };
+
+        // reads straight from the buffer of the stream, so nothing after the snapshot is consumed
+        class Reader {
+            std::istream& in;
+            std::streambuf* buf;
+            std::uint64_t previous_key = 0;
+        public:
+            explicit Reader(std::istream& _in) : in(_in), buf(_in.rdbuf()) {
+                if (!in || !buf) fail("Cannot read the stream.");
+            }
+
+            [[noreturn]] void fail(const char* message) {
+                in.setstate(std::ios::failbit);
+                throw std::runtime_error(message); // EXCEPTION
+            }
+            [[noreturn]] void corrupt() { fail("The stream is not a valid snapshot of this container type."); }
+
+            char get() {
+                auto c = buf->sbumpc();
+                if (c == std::char_traits<char>::eof()) fail("Unexpected end of the stream.");
+                return static_cast<char>(c);
+            }
+            void get(char* data, std::size_t n) {
+                if (static_cast<std::size_t>(buf->sgetn(data, static_cast<std::streamsize>(n))) != n) fail("Unexpected end of the stream.");
+            }
+            std::uint64_t get_varint() {
+                std::uint64_t value = 0;
+                for (unsigned shift = 0; shift < 64; shift += 7) {
+                    unsigned char byte = static_cast<unsigned char>(get());
+                    value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                    if (!(byte & 0x80)) return value;
+                }
+                corrupt();
+            }
+
+            // returns the element count
+            template<typename Key, typename Value>
+            std::size_t read_header(char kind) {
+                char magic[sizeof(MAGIC)];
+                get(magic, sizeof(magic));
+                if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) corrupt();
+                if (static_cast<unsigned char>(get()) != VERSION) fail("Unsupported snapshot version.");
+                if (get() != kind) corrupt();
+                if (static_cast<Encoding>(get()) != encoding_of<Key>() || get_varint() != unit_size_of<Key>()) corrupt();
+                if (static_cast<Encoding>(get()) != encoding_of<Value>() || get_varint() != unit_size_of<Value>()) corrupt();
+                return static_cast<std::size_t>(get_varint());
+            }
+
+            template<typename T>
+            T read_value() {
+                if constexpr (is_integer_v<T>) {
+                    std::uint64_t bits = get_varint();
+                    if constexpr (encoding_of<T>() == Encoding::SIGNED) bits = unzigzag(bits);
+                    return from_bits<T>(bits);
+                }
+                else if constexpr (is_string<T>::value) {
+                    std::uint64_t length = get_varint();
+                    T value;
+                    // the length is not trusted, the string grows with the data that is actually there
+                    while (value.size() < length) {
+                        std::size_t part = static_cast<std::size_t>(std::min<std::uint64_t>(length - value.size(), CHUNK_SIZE));
+                        std::size_t old_size = value.size();
+                        value.resize(old_size + part);
+                        get(reinterpret_cast<char*>(value.data() + old_size), part * sizeof(typename T::value_type));
+                    }
+                    return value;
+                }
+                else {
+                    static_assert(encoding_of<T>() == Encoding::RAW);
+                    T value;
+                    get(reinterpret_cast<char*>(&value), sizeof(T));
+                    return value;
+                }
+            }
+
+            template<typename T>
+            T read_key() {
+                if constexpr (is_integer_v<T>) {
+                    previous_key += unzigzag(get_varint());
+                    return from_bits<T>(previous_key);
+                }
+                else return read_value<T>();
+            }
+
+        private:
+            template<typename T>
+            static T from_bits(std::uint64_t bits) noexcept {
+                if constexpr (std::is_enum_v<T>) return static_cast<T>(from_bits<std::underlying_type_t<T>>(bits));
+                else if constexpr (std::is_same_v<T, bool>) return bits != 0;
+                else return static_cast<T>(bits);
+            }
+        };
+    }
+}
+
+#endif // !__SERIALIZATION_HPP__
\ No newline at end of file
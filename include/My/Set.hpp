@@ -0,0 +1,1142 @@
+﻿#pragma once
+#ifndef __SET_HPP__
+#define __SET_HPP__
+
+#include <iostream>
+#include <utility>
+#include <stdexcept>
+#include <initializer_list>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <memory>
+#include <compare>
+#include <functional>
+#include <mutex>
+#include "Compare.hpp"
+#include "Counters.hpp"
+#include "Serialization.hpp"
+
+namespace My {
+    // Compare is either a three-way comparator returning an ordering (one call per visited node, the default uses operator<=> when the key has one)
+    // or a less-style comparator returning bool
+    // OrderStatistics = true keeps subtree sizes in the nodes, which enables nth() and rank() in O(log n)
+    template <typename T, typename Compare = DefaultCompare, bool OrderStatistics = false>
+    class Set {
+        enum class Color { BLACK, RED };
+
+        struct NoSubtreeSize {};
+        struct SubtreeSize { std::size_t subtree_size = 1; };
+
+        struct TreeNode : std::conditional_t<OrderStatistics, SubtreeSize, NoSubtreeSize> {
+            TreeNode(T _val, Color _color, TreeNode* _parent = nullptr) :
+                val(std::move(_val)), color(_color), left(nullptr), right(nullptr), parent(_parent) {}
+
+            T val;
+            Color color;
+            TreeNode* left;
+            TreeNode* right;
+            TreeNode* parent;
+        };
+
+        // nodes are carved out of contiguous chunks, destroyed nodes are kept for reuse
+        struct NodePool {
+            std::vector<std::pair<TreeNode*, std::size_t>> chunks;
+            std::vector<TreeNode*> released;
+            TreeNode* next = nullptr; // first unused node of the last chunk
+            TreeNode* chunk_end = nullptr;
+            std::size_t next_chunk_size = 16;
+            std::allocator<TreeNode> alloc;
+            [[no_unique_address]] InstanceCounters counter; // the allocations of the chunks
+            // set by split(): the halves may be used on different threads, so from then on the bookkeeping takes the mutex
+            bool shared = false;
+            std::mutex mutex;
+
+            NodePool() = default;
+            NodePool(const NodePool&) = delete;
+            NodePool& operator=(const NodePool&) = delete;
+            ~NodePool() { release_all(); }
+
+            std::unique_lock<std::mutex> guard() { return shared ? std::unique_lock<std::mutex>(mutex) : std::unique_lock<std::mutex>(); }
+            void grow(std::size_t n) {
+                if (static_cast<std::size_t>(chunk_end - next) >= n) return;
+                for (; next != chunk_end; ++next) released.push_back(next);
+                next = alloc.allocate(n);
+                counter.allocation();
+                chunk_end = next + n;
+                chunks.push_back({ next, n });
+            }
+            // the next n nodes created will be adjacent in memory
+            void reserve(std::size_t n) {
+                auto held = guard();
+                grow(n);
+            }
+            template <typename... Args>
+            TreeNode* create(Args&&... args) {
+                TreeNode* node;
+                {
+                    auto held = guard();
+                    if (!released.empty()) {
+                        node = released.back();
+                        released.pop_back();
+                    }
+                    else {
+                        if (next == chunk_end) {
+                            grow(next_chunk_size);
+                            if (next_chunk_size < 4096) next_chunk_size *= 2;
+                        }
+                        node = next++;
+                    }
+                }
+                try {
+                    std::allocator_traits<std::allocator<TreeNode>>::construct(alloc, node, std::forward<Args>(args)...);
+                }
+                catch (...) {
+                    auto held = guard();
+                    released.push_back(node);
+                    throw;
+                }
+                return node;
+            }
+            void destroy(TreeNode* node) {
+                std::allocator_traits<std::allocator<TreeNode>>::destroy(alloc, node);
+                auto held = guard();
+                released.push_back(node);
+            }
+            // takes over every chunk of other, other must not be used by any other set
+            void splice(NodePool& other) {
+                auto held = guard();
+                for (; other.next != other.chunk_end; ++other.next) released.push_back(other.next);
+                chunks.insert(chunks.end(), other.chunks.begin(), other.chunks.end());
+                released.insert(released.end(), other.released.begin(), other.released.end());
+                other.chunks.clear();
+                other.released.clear();
+                other.next = other.chunk_end = nullptr;
+            }
+            // every node must have been destroyed before
+            void release_all() noexcept {
+                auto held = guard();
+                for (auto& chunk : chunks) alloc.deallocate(chunk.first, chunk.second);
+                chunks.clear();
+                released.clear();
+                next = chunk_end = nullptr;
+                next_chunk_size = 16;
+            }
+        };
+
+        TreeNode* root;
+        TreeNode* max_node;
+        std::size_t sz;
+        std::shared_ptr<NodePool> pool; // created on first use, sets produced by split() share the pool of their source
+        Compare comp;
+        [[no_unique_address]] InstanceCounters counter;
+
+        NodePool& node_pool();
+        void clear_traverse();
+        void copy_traverse(const Set& other);
+        TreeNode* get_max_node(TreeNode* cur) const;
+        int compare(const T& lhs, const T& rhs) const;
+        void balancing_after_insert(TreeNode* cur);
+        void right_rotation(TreeNode* y, TreeNode* g);
+        void left_rotation(TreeNode* y, TreeNode* g);
+        static std::size_t subtree_size(const TreeNode* cur) noexcept;
+        void update_subtree_size(TreeNode* cur) noexcept;
+        void increase_subtree_sizes(TreeNode* inserted) noexcept;
+        template <typename InputIt> void assign_sorted(InputIt first, InputIt last);
+        TreeNode* build_balanced(std::vector<TreeNode*>& nodes);
+        TreeNode* build_balanced(std::vector<TreeNode*>& nodes, std::size_t lo, std::size_t hi, std::size_t depth, std::size_t red_depth, TreeNode* parent);
+        TreeNode* read_balanced(SerializationDetail::Reader& reader, TreeNode*& last, std::size_t lo, std::size_t hi, std::size_t depth, std::size_t red_depth);
+
+        // join-based algorithms, they work on detached subtrees and return the new subtree root
+        static Color color_of(const TreeNode* cur) noexcept { return cur ? cur->color : Color::BLACK; }
+        static std::size_t black_height(const TreeNode* cur) noexcept;
+        static TreeNode* leftmost(TreeNode* cur) noexcept;
+        static TreeNode* successor(TreeNode* cur) noexcept;
+        void link(TreeNode* cur, TreeNode* left, TreeNode* right) noexcept;
+        TreeNode* rotate_subtree_left(TreeNode* cur) noexcept;
+        TreeNode* rotate_subtree_right(TreeNode* cur) noexcept;
+        TreeNode* join_right(TreeNode* left, std::size_t left_bh, TreeNode* key, TreeNode* right, std::size_t right_bh);
+        TreeNode* join_left(TreeNode* left, std::size_t left_bh, TreeNode* key, TreeNode* right, std::size_t right_bh);
+        TreeNode* join_trees(TreeNode* left, TreeNode* key, TreeNode* right);
+        TreeNode* join_trees(TreeNode* left, TreeNode* right);
+        void split_tree(TreeNode* cur, const T& key, TreeNode*& less, TreeNode*& found, TreeNode*& greater);
+        void split_last(TreeNode* cur, TreeNode*& rest, TreeNode*& last);
+        // the set operations add the number of nodes they drop to dropped, the caller takes it off sz
+        TreeNode* union_trees(TreeNode* first, TreeNode* second, std::size_t& dropped);
+        TreeNode* intersect_trees(TreeNode* first, TreeNode* second, std::size_t& dropped);
+        TreeNode* difference_trees(TreeNode* first, TreeNode* second, std::size_t& dropped);
+        void drop_node(TreeNode* cur);
+        std::size_t drop_tree(TreeNode* top); // returns the number of dropped nodes
+        TreeNode* adopt(Set& other);
+        void set_root(TreeNode* new_root);
+
+    public:
+        class iterator {
+            TreeNode* ptr;
+            Set* this_set;
+        public:
+            iterator() = default;
+            iterator(TreeNode* _ptr, Set* _this_set) : ptr(_ptr), this_set(_this_set) {}
+            bool operator ==(const iterator& other) { return ptr == other.ptr; }
+            bool operator !=(const iterator& other) { return !(*this == other); }
+            iterator& operator++() {
+                if (ptr->right) {
+                    ptr = ptr->right;
+                    while (ptr->left) ptr = ptr->left;
+                }
+                else {
+                    while (ptr->parent && ptr == ptr->parent->right) ptr = ptr->parent;
+                    ptr = ptr->parent;
+                }
+                return *this;
+            }
+            iterator operator++(int) {
+                iterator tmp = *this;
+                ++* this;
+                return tmp;
+            }
+            const T& operator*() { return ptr->val; }
+        };
+
+        Set(const Compare& _comp = Compare());
+        Set(std::initializer_list<T> init_list, const Compare& _comp = Compare());
+        Set(const Set& other);
+        Set(Set&& other) noexcept;
+
+        ~Set();
+
+        // builds a balanced red-black tree in O(n), [first, last) must be sorted, duplicates are skipped;
+        // throws std::invalid_argument on an element smaller than the one before it
+        template <typename InputIt> static Set from_sorted(InputIt first, InputIt last, const Compare& _comp = Compare());
+        // sorts a copy of [first, last) and then builds the tree with from_sorted()
+        template <typename InputIt> static Set from_unsorted(InputIt first, InputIt last, const Compare& _comp = Compare());
+
+        Set& operator=(const Set& other);
+        Set& operator=(Set&& other) noexcept;
+
+        void insert(const T& key);
+        void clear();
+        bool empty() const noexcept;
+        std::size_t size() const noexcept;
+        bool count(const T& key) const noexcept;
+
+        // available only with OrderStatistics = true
+        iterator nth(std::size_t index); // the element with 0-based position index in sorted order
+        std::size_t rank(const T& key) const noexcept; // the number of keys less than key
+
+        // compact binary snapshot in sorted order, see Serialization.hpp for the format
+        void write_to(std::ostream& out) const; // streams through a fixed size buffer, no copy of the elements is made
+        // replaces the contents, the tree is built bottom-up in O(n) as the elements arrive; a failed read leaves the set empty
+        void read_from(std::istream& in);
+
+        Counters counters() const noexcept; // zeros unless MY_CONTAINERS_STATS is defined, allocations include the sets sharing the node storage
+        void reset_counters() noexcept;
+
+        // join-based bulk operations, they relink the nodes of both trees instead of allocating new ones
+        // and run in O(m log(n / m + 1)) for sets of sizes m <= n
+        // every key of greater must be greater than every key of *this, otherwise std::invalid_argument is thrown; greater is left empty
+        void join(Set& greater);
+        // keeps the keys less than key and returns the rest, no node is copied; the tree is cut in O(log n), without
+        // OrderStatistics the sizes k and n - k of the halves are counted in O(min(k, n - k)) on top of that.
+        // Both sets share the node storage afterwards, which then takes a lock, so they can be used on different threads
+        Set split(const T& key);
+        void merge(Set& other); // moves the keys of other into *this, other is left empty
+        void set_union(Set other); // pass an rvalue to reuse the nodes of other, an lvalue is copied first
+        void set_intersection(Set other);
+        void set_difference(Set other);
+
+        iterator begin();
+        iterator end();
+    };
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::NodePool& Set<T, Compare, OrderStatistics>::node_pool() {
+        if (!pool) pool = std::make_shared<NodePool>();
+        return *pool;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::clear_traverse() {
+        if (pool.use_count() > 1) { // another set still uses the chunks
+            drop_tree(root);
+            return;
+        }
+        // values that need no destructor call are released together with the chunks
+        if constexpr (!std::is_trivially_destructible_v<TreeNode>) drop_tree(root);
+        pool->release_all();
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::copy_traverse(const Set& other) {
+        if (pool.use_count() > 1) pool.reset(); // the copy gets chunks of its own
+        node_pool().reserve(other.sz);
+        counter.copy(other.sz);
+        root = node_pool().create(other.root->val, other.root->color);
+        if constexpr (OrderStatistics) root->subtree_size = other.root->subtree_size;
+
+        // preorder walk over both trees at once, a missing child in the copy means it was not visited yet
+        const TreeNode* other_cur = other.root;
+        TreeNode* cur = root;
+        while (other_cur) {
+            if (other_cur->left && !cur->left) {
+                cur->left = node_pool().create(other_cur->left->val, other_cur->left->color, cur);
+                if constexpr (OrderStatistics) cur->left->subtree_size = other_cur->left->subtree_size;
+                other_cur = other_cur->left;
+                cur = cur->left;
+            }
+            else if (other_cur->right && !cur->right) {
+                cur->right = node_pool().create(other_cur->right->val, other_cur->right->color, cur);
+                if constexpr (OrderStatistics) cur->right->subtree_size = other_cur->right->subtree_size;
+                other_cur = other_cur->right;
+                cur = cur->right;
+            }
+            else {
+                other_cur = other_cur->parent;
+                cur = cur->parent;
+            }
+        }
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    int Set<T, Compare, OrderStatistics>::compare(const T& lhs, const T& rhs) const {
+        if constexpr (std::is_same_v<std::invoke_result_t<const Compare&, const T&, const T&>, bool>) {
+            if (comp(lhs, rhs)) return -1;
+            return comp(rhs, lhs) ? 1 : 0;
+        }
+        else {
+            auto order = comp(lhs, rhs);
+            return order < 0 ? -1 : (order > 0 ? 1 : 0);
+        }
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::balancing_after_insert(TreeNode* cur) {
+        if (cur == root) {
+            cur->color = Color::BLACK;
+            return;
+        }
+
+        TreeNode* pParent = cur->parent;
+        TreeNode* pGrandparent = nullptr;
+        if (pParent->parent) pGrandparent = pParent->parent;
+        if (!pGrandparent) return;
+
+        TreeNode* pUncle = nullptr;
+        if (pParent == pGrandparent->left) {
+            if (pGrandparent->right) pUncle = pGrandparent->right;
+        }
+        else {
+            if (pGrandparent->left) pUncle = pGrandparent->left;
+        }
+
+        if (!pUncle || pUncle->color == Color::BLACK) {
+            if ((cur == pParent->left && pParent == pGrandparent->left) || (cur == pParent->right && pParent == pGrandparent->right)) {
+                if (cur == pParent->left && pParent == pGrandparent->left) {
+                    right_rotation(pParent, pGrandparent);
+                }
+                else {
+                    left_rotation(pParent, pGrandparent);
+                }
+                pGrandparent->color = Color::RED;
+                pParent->color = Color::BLACK;
+            }
+            else {
+                if (cur == pParent->right && pParent == pGrandparent->left) {
+                    left_rotation(cur, pParent);
+                    right_rotation(cur, pGrandparent);
+                }
+                else {
+                    right_rotation(cur, pParent);
+                    left_rotation(cur, pGrandparent);
+                }
+                pGrandparent->color = Color::RED;
+                cur->color = Color::BLACK;
+            }
+        }
+        else {
+            pUncle->color = Color::BLACK;
+            pParent->color = Color::BLACK;
+            pGrandparent->color = Color::RED;
+            if (pGrandparent == root || pGrandparent->parent->color == Color::RED) balancing_after_insert(pGrandparent);
+        }
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::right_rotation(TreeNode* pChild, TreeNode* pParent) {
+        counter.rotation();
+        pChild->parent = pParent->parent;
+
+        if (pParent != root) {
+            if (pParent->parent->left == pParent) pParent->parent->left = pChild;
+            else if (pParent->parent->right == pParent) pParent->parent->right = pChild;
+        }
+        pParent->parent = pChild;
+
+        pParent->left = pChild->right;
+        if (pChild->right) pChild->right->parent = pParent;
+        pChild->right = pParent;
+
+        if (pParent == root) root = pChild;
+
+        update_subtree_size(pParent);
+        update_subtree_size(pChild);
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::left_rotation(TreeNode* pChild, TreeNode* pParent) {
+        counter.rotation();
+        pChild->parent = pParent->parent;
+
+        if (pParent != root) {
+            if (pParent->parent->left == pParent) pParent->parent->left = pChild;
+            else if (pParent->parent->right == pParent) pParent->parent->right = pChild;
+        }
+        pParent->parent = pChild;
+
+        pParent->right = pChild->left;
+        if (pChild->left) pChild->left->parent = pParent;
+        pChild->left = pParent;
+
+        if (pParent == root) root = pChild;
+
+        update_subtree_size(pParent);
+        update_subtree_size(pChild);
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    std::size_t Set<T, Compare, OrderStatistics>::subtree_size(const TreeNode* cur) noexcept {
+        if constexpr (OrderStatistics) return cur ? cur->subtree_size : 0;
+        else return 0;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::update_subtree_size(TreeNode* cur) noexcept {
+        if constexpr (OrderStatistics) cur->subtree_size = 1 + subtree_size(cur->left) + subtree_size(cur->right);
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::increase_subtree_sizes(TreeNode* inserted) noexcept {
+        if constexpr (OrderStatistics) {
+            for (TreeNode* cur = inserted->parent; cur; cur = cur->parent) cur->subtree_size++;
+        }
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    template<typename InputIt>
+    void Set<T, Compare, OrderStatistics>::assign_sorted(InputIt first, InputIt last) {
+        std::vector<TreeNode*> nodes;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>) {
+            nodes.reserve(std::distance(first, last));
+            node_pool().reserve(nodes.capacity());
+        }
+
+        for (; first != last; ++first) {
+            T value = *first;
+            counter.construction<T, decltype(*first)>();
+            if (!nodes.empty()) {
+                int order = compare(nodes.back()->val, value);
+                if (order == 0) continue;
+                if (order > 0) {
+                    for (TreeNode* node : nodes) pool->destroy(node);
+                    throw std::invalid_argument("Set::from_sorted() needs elements in ascending order, use from_unsorted()."); // EXCEPTION
+                }
+            }
+            nodes.push_back(node_pool().create(std::move(value), Color::BLACK));
+        }
+        if (nodes.empty()) return;
+
+        root = build_balanced(nodes);
+        max_node = nodes.back();
+        sz = nodes.size();
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::build_balanced(std::vector<TreeNode*>& nodes) {
+        // levels 0 .. red_depth - 1 are complete, so the nodes of the last (incomplete) level are colored red
+        std::size_t red_depth = 0;
+        while ((std::size_t(2) << red_depth) - 1 <= nodes.size()) red_depth++;
+
+        return build_balanced(nodes, 0, nodes.size(), 0, red_depth, nullptr);
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::build_balanced(std::vector<TreeNode*>& nodes, std::size_t lo, std::size_t hi, std::size_t depth, std::size_t red_depth, TreeNode* parent) {
+        if (lo >= hi) return nullptr;
+
+        std::size_t mid = lo + (hi - lo) / 2;
+        TreeNode* cur = nodes[mid];
+        cur->parent = parent;
+        cur->color = depth == red_depth ? Color::RED : Color::BLACK;
+        cur->left = build_balanced(nodes, lo, mid, depth + 1, red_depth, cur);
+        cur->right = build_balanced(nodes, mid + 1, hi, depth + 1, red_depth, cur);
+        if constexpr (OrderStatistics) cur->subtree_size = hi - lo;
+        return cur;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    std::size_t Set<T, Compare, OrderStatistics>::black_height(const TreeNode* cur) noexcept {
+        std::size_t height = 0;
+        for (; cur; cur = cur->left) {
+            if (cur->color == Color::BLACK) height++;
+        }
+        return height;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::leftmost(TreeNode* cur) noexcept {
+        if (cur) {
+            while (cur->left) cur = cur->left;
+        }
+        return cur;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::successor(TreeNode* cur) noexcept {
+        if (cur->right) return leftmost(cur->right);
+        while (cur->parent && cur == cur->parent->right) cur = cur->parent;
+        return cur->parent;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::link(TreeNode* cur, TreeNode* left, TreeNode* right) noexcept {
+        cur->left = left;
+        cur->right = right;
+        if (left) left->parent = cur;
+        if (right) right->parent = cur;
+        update_subtree_size(cur);
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::rotate_subtree_left(TreeNode* cur) noexcept {
+        counter.rotation();
+        TreeNode* new_top = cur->right;
+        link(cur, cur->left, new_top->left);
+        link(new_top, cur, new_top->right);
+        new_top->parent = nullptr;
+        return new_top;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::rotate_subtree_right(TreeNode* cur) noexcept {
+        counter.rotation();
+        TreeNode* new_top = cur->left;
+        link(cur, new_top->right, cur->right);
+        link(new_top, new_top->left, cur);
+        new_top->parent = nullptr;
+        return new_top;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::join_right(TreeNode* left, std::size_t left_bh, TreeNode* key, TreeNode* right, std::size_t right_bh) {
+        // walk down the right spine of the higher tree until the black heights match
+        if (color_of(left) == Color::BLACK && left_bh == right_bh) {
+            key->color = Color::RED;
+            link(key, left, right);
+            return key;
+        }
+
+        TreeNode* joined = join_right(left->right, left_bh - (left->color == Color::BLACK ? 1 : 0), key, right, right_bh);
+        link(left, left->left, joined);
+        if (left->color == Color::BLACK && joined->color == Color::RED && color_of(joined->right) == Color::RED) {
+            joined->right->color = Color::BLACK;
+            return rotate_subtree_left(left);
+        }
+        return left;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::join_left(TreeNode* left, std::size_t left_bh, TreeNode* key, TreeNode* right, std::size_t right_bh) {
+        if (color_of(right) == Color::BLACK && left_bh == right_bh) {
+            key->color = Color::RED;
+            link(key, left, right);
+            return key;
+        }
+
+        TreeNode* joined = join_left(left, left_bh, key, right->left, right_bh - (right->color == Color::BLACK ? 1 : 0));
+        link(right, joined, right->right);
+        if (right->color == Color::BLACK && joined->color == Color::RED && color_of(joined->left) == Color::RED) {
+            joined->left->color = Color::BLACK;
+            return rotate_subtree_right(right);
+        }
+        return right;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::join_trees(TreeNode* left, TreeNode* key, TreeNode* right) {
+        // every key of left < key < every key of right, both roots may be red
+        if (left) left->color = Color::BLACK;
+        if (right) right->color = Color::BLACK;
+        std::size_t left_bh = black_height(left);
+        std::size_t right_bh = black_height(right);
+
+        TreeNode* joined;
+        if (left_bh > right_bh) {
+            joined = join_right(left, left_bh, key, right, right_bh);
+            if (joined->color == Color::RED && color_of(joined->right) == Color::RED) joined->color = Color::BLACK;
+        }
+        else if (right_bh > left_bh) {
+            joined = join_left(left, left_bh, key, right, right_bh);
+            if (joined->color == Color::RED && color_of(joined->left) == Color::RED) joined->color = Color::BLACK;
+        }
+        else {
+            key->color = Color::RED;
+            link(key, left, right);
+            joined = key;
+        }
+        joined->parent = nullptr;
+        return joined;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::join_trees(TreeNode* left, TreeNode* right) {
+        if (!left) return right;
+        if (!right) return left;
+
+        TreeNode* rest;
+        TreeNode* last;
+        split_last(left, rest, last);
+        return join_trees(rest, last, right);
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::split_tree(TreeNode* cur, const T& key, TreeNode*& less, TreeNode*& found, TreeNode*& greater) {
+        if (!cur) {
+            less = found = greater = nullptr;
+            return;
+        }
+
+        TreeNode* left = cur->left;
+        TreeNode* right = cur->right;
+        TreeNode* middle;
+        int order = compare(key, cur->val);
+        if (order < 0) {
+            split_tree(left, key, less, found, middle);
+            greater = join_trees(middle, cur, right);
+        }
+        else if (order > 0) {
+            split_tree(right, key, middle, found, greater);
+            less = join_trees(left, cur, middle);
+        }
+        else {
+            less = left;
+            greater = right;
+            found = cur;
+            if (less) less->parent = nullptr;
+            if (greater) greater->parent = nullptr;
+        }
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::split_last(TreeNode* cur, TreeNode*& rest, TreeNode*& last) {
+        if (!cur->right) {
+            rest = cur->left;
+            if (rest) rest->parent = nullptr;
+            last = cur;
+            return;
+        }
+
+        TreeNode* right_rest;
+        split_last(cur->right, right_rest, last);
+        rest = join_trees(cur->left, cur, right_rest);
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::union_trees(TreeNode* first, TreeNode* second, std::size_t& dropped) {
+        if (!first) return second;
+        if (!second) return first;
+
+        TreeNode* left = second->left;
+        TreeNode* right = second->right;
+        TreeNode* less;
+        TreeNode* found;
+        TreeNode* greater;
+        split_tree(first, second->val, less, found, greater);
+
+        TreeNode* key = second;
+        if (found) { // keep the element of the first tree
+            drop_node(second);
+            dropped++;
+            key = found;
+        }
+        return join_trees(union_trees(less, left, dropped), key, union_trees(greater, right, dropped));
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::intersect_trees(TreeNode* first, TreeNode* second, std::size_t& dropped) {
+        if (!first || !second) {
+            dropped += drop_tree(first) + drop_tree(second);
+            return nullptr;
+        }
+
+        TreeNode* left = second->left;
+        TreeNode* right = second->right;
+        TreeNode* less;
+        TreeNode* found;
+        TreeNode* greater;
+        split_tree(first, second->val, less, found, greater);
+        drop_node(second);
+        dropped++;
+
+        TreeNode* joined_left = intersect_trees(less, left, dropped);
+        TreeNode* joined_right = intersect_trees(greater, right, dropped);
+        if (found) return join_trees(joined_left, found, joined_right);
+        return join_trees(joined_left, joined_right);
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::difference_trees(TreeNode* first, TreeNode* second, std::size_t& dropped) {
+        if (!first) {
+            dropped += drop_tree(second);
+            return nullptr;
+        }
+        if (!second) return first;
+
+        TreeNode* left = second->left;
+        TreeNode* right = second->right;
+        TreeNode* less;
+        TreeNode* found;
+        TreeNode* greater;
+        split_tree(first, second->val, less, found, greater);
+        drop_node(second);
+        dropped++;
+        if (found) {
+            drop_node(found);
+            dropped++;
+        }
+
+        return join_trees(difference_trees(less, left, dropped), difference_trees(greater, right, dropped));
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::drop_node(TreeNode* cur) {
+        pool->destroy(cur);
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    std::size_t Set<T, Compare, OrderStatistics>::drop_tree(TreeNode* top) {
+        if (!top) return 0;
+
+        // bottom-up walk through parent pointers, it stops when it climbs above top
+        top->parent = nullptr;
+        TreeNode* cur = top;
+        std::size_t dropped = 0;
+        while (cur) {
+            if (cur->left) cur = cur->left;
+            else if (cur->right) cur = cur->right;
+            else {
+                TreeNode* parent = cur->parent;
+                if (parent) {
+                    if (parent->left == cur) parent->left = nullptr;
+                    else parent->right = nullptr;
+                }
+                drop_node(cur);
+                dropped++;
+                cur = parent;
+            }
+        }
+        return dropped;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::adopt(Set& other) {
+        // makes the nodes of other owned by the pool of *this
+        TreeNode* other_root = other.root;
+        std::size_t other_size = other.sz;
+        if (other_root && other.pool != pool) {
+            if (other.pool.use_count() == 1) node_pool().splice(*other.pool);
+            else {
+                // other shares its chunks with a third set, so its elements are moved into new nodes
+                std::vector<TreeNode*> nodes;
+                nodes.reserve(other_size);
+                node_pool().reserve(other_size);
+                for (TreeNode* cur = leftmost(other_root); cur; cur = successor(cur)) {
+                    nodes.push_back(node_pool().create(std::move(cur->val), Color::BLACK));
+                    counter.move();
+                }
+                other.drop_tree(other_root);
+                other_root = build_balanced(nodes);
+            }
+        }
+
+        other.root = other.max_node = nullptr;
+        other.sz = 0;
+        sz += other_size;
+        return other_root;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::set_root(TreeNode* new_root) {
+        root = new_root;
+        if (root) {
+            root->parent = nullptr;
+            root->color = Color::BLACK;
+            max_node = get_max_node(root);
+        }
+        else max_node = nullptr;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::read_balanced(SerializationDetail::Reader& reader, TreeNode*& last, std::size_t lo, std::size_t hi, std::size_t depth, std::size_t red_depth) {
+        if (lo >= hi) return nullptr;
+
+        // the same shape as build_balanced(), but the nodes are created in order while the subtrees are linked
+        std::size_t mid = lo + (hi - lo) / 2;
+        TreeNode* left = read_balanced(reader, last, lo, mid, depth + 1, red_depth);
+        TreeNode* cur;
+        try {
+            T key = reader.read_key<T>();
+            if (last && compare(last->val, key) >= 0) reader.corrupt();
+            cur = node_pool().create(std::move(key), depth == red_depth ? Color::RED : Color::BLACK);
+        }
+        catch (...) {
+            drop_tree(left);
+            throw;
+        }
+        last = cur;
+        cur->left = left;
+        if (left) left->parent = cur;
+        try {
+            cur->right = read_balanced(reader, last, mid + 1, hi, depth + 1, red_depth);
+        }
+        catch (...) {
+            drop_tree(cur);
+            throw;
+        }
+        if (cur->right) cur->right->parent = cur;
+        if constexpr (OrderStatistics) cur->subtree_size = hi - lo;
+        return cur;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::TreeNode* Set<T, Compare, OrderStatistics>::get_max_node(TreeNode* cur) const {
+        while (cur->right) cur = cur->right;
+        return cur;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    Set<T, Compare, OrderStatistics>::Set(const Compare& _comp) : sz(0), root(nullptr), max_node(nullptr), comp(_comp) {}
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    Set<T, Compare, OrderStatistics>::Set(std::initializer_list<T> init_list, const Compare& _comp) : Set(_comp) {
+        std::vector<T> sorted(init_list.begin(), init_list.end());
+        std::sort(sorted.begin(), sorted.end(), [this](const T& a, const T& b) { return compare(a, b) < 0; });
+        assign_sorted(std::make_move_iterator(sorted.begin()), std::make_move_iterator(sorted.end()));
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    Set<T, Compare, OrderStatistics>::Set(const Set& other) : sz(other.sz), comp(other.comp) {
+        if (other.root) {
+            copy_traverse(other);
+            max_node = get_max_node(root);
+        }
+        else root = max_node = nullptr;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    Set<T, Compare, OrderStatistics>::Set(Set&& other) noexcept : sz(other.sz), root(other.root), max_node(other.max_node), pool(std::move(other.pool)), comp(std::move(other.comp)) {
+        other.root = nullptr;
+        other.max_node = nullptr;
+        other.sz = 0;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    Set<T, Compare, OrderStatistics>::~Set() { clear(); }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    template<typename InputIt>
+    Set<T, Compare, OrderStatistics> Set<T, Compare, OrderStatistics>::from_sorted(InputIt first, InputIt last, const Compare& _comp) {
+        Set result(_comp);
+        result.assign_sorted(first, last);
+        return result;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    template<typename InputIt>
+    Set<T, Compare, OrderStatistics> Set<T, Compare, OrderStatistics>::from_unsorted(InputIt first, InputIt last, const Compare& _comp) {
+        Set result(_comp);
+        std::vector<T> sorted(first, last);
+        std::sort(sorted.begin(), sorted.end(), [&result](const T& a, const T& b) { return result.compare(a, b) < 0; });
+        result.assign_sorted(std::make_move_iterator(sorted.begin()), std::make_move_iterator(sorted.end()));
+        return result;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    Set<T, Compare, OrderStatistics>& Set<T, Compare, OrderStatistics>::operator=(const Set& other) {
+        if (this != &other) {
+            clear();
+
+            sz = other.sz;
+            comp = other.comp;
+            if (other.root) {
+                copy_traverse(other);
+                max_node = get_max_node(root);
+            }
+            else root = max_node = nullptr;
+        }
+        return *this;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    Set<T, Compare, OrderStatistics>& Set<T, Compare, OrderStatistics>::operator=(Set&& other) noexcept {
+        if (this != &other) {
+            clear();
+
+            sz = other.sz;
+            root = other.root;
+            max_node = other.max_node;
+            pool = std::move(other.pool);
+            comp = std::move(other.comp);
+
+            other.sz = 0;
+            other.root = nullptr;
+            other.max_node = nullptr;
+        }
+        return *this;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::insert(const T& key) {
+        if (!root) {
+            root = node_pool().create(key, Color::BLACK);
+            counter.copy();
+            max_node = root;
+            sz++;
+            return;
+        }
+
+        bool can_be_max = true;
+        TreeNode* cur = root;
+        while (true) {
+            int order = compare(key, cur->val);
+            if (order > 0) {
+                if (cur->right) cur = cur->right;
+                else {
+                    cur->right = node_pool().create(key, Color::RED, cur);
+                    increase_subtree_sizes(cur->right);
+                    if (can_be_max) max_node = cur->right;
+                    if (cur->color == Color::RED) balancing_after_insert(cur->right);
+                    break;
+                }
+            }
+            else if (order < 0) {
+                can_be_max = false;
+                if (cur->left) cur = cur->left;
+                else {
+                    cur->left = node_pool().create(key, Color::RED, cur);
+                    increase_subtree_sizes(cur->left);
+                    if (cur->color == Color::RED) balancing_after_insert(cur->left);
+                    break;
+                }
+            }
+            else return;
+        }
+        counter.copy();
+        sz++;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::clear() {
+        if (!root) return;
+
+        clear_traverse();
+
+        sz = 0;
+        root = max_node = nullptr;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    bool Set<T, Compare, OrderStatistics>::empty() const noexcept { return sz == 0; }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    std::size_t Set<T, Compare, OrderStatistics>::size() const noexcept { return sz; }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    bool Set<T, Compare, OrderStatistics>::count(const T& key) const noexcept {
+        if (!root) return false;
+
+        TreeNode* cur = root;
+        while (true) {
+            int order = compare(key, cur->val);
+            if (order > 0) {
+                if (cur->right) cur = cur->right;
+                else return false;
+            }
+            else if (order < 0) {
+                if (cur->left) cur = cur->left;
+                else return false;
+            }
+            else return true;
+        }
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::iterator Set<T, Compare, OrderStatistics>::nth(std::size_t index) {
+        static_assert(OrderStatistics, "nth() requires OrderStatistics = true");
+        if (index >= sz) throw std::out_of_range("set nth index outside range."); // EXCEPTION
+
+        TreeNode* cur = root;
+        while (true) {
+            std::size_t left_size = subtree_size(cur->left);
+            if (index < left_size) cur = cur->left;
+            else if (index > left_size) {
+                index -= left_size + 1;
+                cur = cur->right;
+            }
+            else return iterator(cur, this);
+        }
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    std::size_t Set<T, Compare, OrderStatistics>::rank(const T& key) const noexcept {
+        static_assert(OrderStatistics, "rank() requires OrderStatistics = true");
+
+        std::size_t less = 0;
+        TreeNode* cur = root;
+        while (cur) {
+            if (compare(key, cur->val) > 0) {
+                less += subtree_size(cur->left) + 1;
+                cur = cur->right;
+            }
+            else cur = cur->left;
+        }
+        return less;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::join(Set& greater) {
+        if (&greater == this) return;
+        if (max_node && greater.root && compare(max_node->val, leftmost(greater.root)->val) >= 0) {
+            throw std::invalid_argument("Set::join() needs every key of greater to be greater than every key of *this."); // EXCEPTION
+        }
+        TreeNode* greater_root = adopt(greater);
+        set_root(join_trees(root, greater_root));
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    Set<T, Compare, OrderStatistics> Set<T, Compare, OrderStatistics>::split(const T& key) {
+        Set greater_set(comp);
+        if (!root) return greater_set;
+
+        TreeNode* less;
+        TreeNode* found;
+        TreeNode* greater;
+        split_tree(root, key, less, found, greater);
+        if (found) greater = join_trees(nullptr, found, greater);
+
+        std::size_t less_size;
+        if constexpr (OrderStatistics) less_size = subtree_size(less);
+        else {
+            // walk both halves in lockstep, the one that ends first is counted exactly in O(min(k, n - k))
+            std::size_t steps = 0;
+            TreeNode* a = leftmost(less);
+            TreeNode* b = leftmost(greater);
+            while (a && b) {
+                a = successor(a);
+                b = successor(b);
+                steps++;
+            }
+            less_size = a ? sz - steps : steps;
+        }
+
+        // the nodes stay where they are, so both halves keep the pool and it starts locking
+        if (!pool->shared) pool->shared = true;
+        greater_set.pool = pool;
+        greater_set.set_root(greater);
+        greater_set.sz = sz - less_size;
+        set_root(less);
+        sz = less_size;
+        return greater_set;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::merge(Set& other) {
+        if (&other == this) return;
+        TreeNode* other_root = adopt(other);
+        std::size_t dropped = 0;
+        set_root(union_trees(root, other_root, dropped));
+        sz -= dropped;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::set_union(Set other) { merge(other); }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::set_intersection(Set other) {
+        TreeNode* other_root = adopt(other);
+        std::size_t dropped = 0;
+        set_root(intersect_trees(root, other_root, dropped));
+        sz -= dropped;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::set_difference(Set other) {
+        TreeNode* other_root = adopt(other);
+        std::size_t dropped = 0;
+        set_root(difference_trees(root, other_root, dropped));
+        sz -= dropped;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::write_to(std::ostream& out) const {
+        SerializationDetail::Writer writer(out);
+        writer.write_header<T, void>('S', sz);
+        for (TreeNode* cur = leftmost(root); cur; cur = successor(cur)) writer.write_key(cur->val);
+        writer.flush();
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::read_from(std::istream& in) {
+        clear();
+        SerializationDetail::Reader reader(in);
+        std::size_t count = reader.read_header<T, void>('S');
+        if (!count) return;
+
+        if (pool.use_count() > 1) pool.reset(); // the snapshot gets chunks of its own
+        // the count comes from the stream, so only a bounded part is reserved up front and the pool grows as the nodes
+        // are read; a count past the end of the data ends in the reader's "Unexpected end of the stream."
+        node_pool().reserve(std::min(count, SerializationDetail::CHUNK_SIZE));
+        // levels 0 .. red_depth - 1 are complete, so the nodes of the last (incomplete) level are colored red
+        std::size_t red_depth = 0;
+        while ((std::size_t(2) << red_depth) - 1 <= count) red_depth++;
+
+        TreeNode* last = nullptr;
+        root = read_balanced(reader, last, 0, count, 0, red_depth);
+        max_node = last;
+        sz = count;
+        counter.move(count);
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    Counters Set<T, Compare, OrderStatistics>::counters() const noexcept {
+        Counters result = counter.get();
+        if (pool) result.allocations += pool->counter.get().allocations;
+        return result;
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    void Set<T, Compare, OrderStatistics>::reset_counters() noexcept {
+        counter.reset();
+        if (pool) pool->counter.reset();
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::iterator Set<T, Compare, OrderStatistics>::begin() {
+        if (!root) return iterator(nullptr, this);
+
+        TreeNode* cur = root;
+        while (cur->left) {
+            cur = cur->left;
+        }
+        return iterator(cur, this);
+    }
+
+    template<typename T, typename Compare, bool OrderStatistics>
+    typename Set<T, Compare, OrderStatistics>::iterator Set<T, Compare, OrderStatistics>::end() {
+        if (!root) return iterator(nullptr, this);
+
+        return iterator(max_node->right, this);
+    }
+}
+
+#endif // !__SET_HPP__
\ No newline at end of file
@@ -0,0 +1,517 @@
+﻿#pragma once
+#ifndef __UNROLLED_LIST_HPP__
+#define __UNROLLED_LIST_HPP__
+
+#include <utility>
+#include <stdexcept>
+#include <initializer_list>
+#include <memory>
+#include <iterator>
+#include <new>
+#include <cstddef>
+
+namespace My {
+    // doubly linked list of blocks, every block stores up to capacity elements in a contiguous array,
+    // so a scan touches one heap node per capacity elements instead of one per element
+    template <typename T, std::size_t BlockBytes = 256, typename Allocator = std::allocator<T>>
+    class UnrolledList {
+        struct NodeBase {
+            NodeBase* next;
+            NodeBase* prev;
+            std::size_t count = 0; // 0 only for the sentinel, empty blocks are unlinked
+        };
+        static constexpr std::size_t header_bytes = sizeof(NodeBase);
+        static constexpr std::size_t capacity = BlockBytes > header_bytes + sizeof(T) ? (BlockBytes - header_bytes) / sizeof(T) : 1;
+
+        struct Node : NodeBase {
+            alignas(T) unsigned char storage[capacity * sizeof(T)];
+            T* data() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+        };
+        using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+        using NodeTraits = std::allocator_traits<NodeAllocator>;
+
+        NodeBase sentinel; // circular list of blocks, end() points to sentinel
+        Node* spare; // one empty block kept to avoid an allocation on every split after an erase emptied a block
+        std::size_t sz;
+        NodeAllocator alloc;
+
+        Node* create_node();
+        void destroy_node(Node* node) noexcept;
+        void take_links(UnrolledList& other) noexcept;
+        static void link_after(NodeBase* position, NodeBase* node) noexcept;
+        static void unlink(NodeBase* node) noexcept;
+        template<typename... Args>
+        std::pair<Node*, std::size_t> emplace_impl(NodeBase* position, std::size_t index, Args&&... args);
+
+    public:
+        class iterator {
+            // element pointers instead of an index keep ++ down to one compare inside a block
+            NodeBase* ptr;
+            T* cur; // nullptr for end()
+            T* block_end;
+
+            void enter(NodeBase* node) noexcept {
+                ptr = node;
+                cur = node->count ? static_cast<Node*>(node)->data() : nullptr;
+                block_end = cur + node->count;
+            }
+            std::size_t index() const noexcept { return cur ? cur - static_cast<Node*>(ptr)->data() : 0; }
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            friend class UnrolledList;
+            iterator() = default;
+            iterator(NodeBase* _ptr, std::size_t _index) { enter(_ptr); cur += _index; }
+            iterator& operator++() {
+                if (++cur == block_end) enter(ptr->next);
+                return *this;
+            }
+            iterator operator++(int) { iterator tmp = *this; ++*this; return tmp; }
+            iterator& operator--() {
+                if (!cur || cur == static_cast<Node*>(ptr)->data()) {
+                    enter(ptr->prev);
+                    cur = block_end;
+                }
+                --cur;
+                return *this;
+            }
+            iterator operator--(int) { iterator tmp = *this; --*this; return tmp; }
+            bool operator==(const iterator& other) const noexcept { return cur == other.cur; }
+            bool operator!=(const iterator& other) const noexcept { return !(*this == other); }
+            T& operator*() const noexcept { return *cur; }
+            T* operator->() const noexcept { return cur; }
+        };
+
+        UnrolledList(const Allocator& _alloc = Allocator());
+        UnrolledList(std::size_t size, const Allocator& _alloc = Allocator());
+        UnrolledList(std::size_t size, const T& value, const Allocator& _alloc = Allocator());
+        UnrolledList(std::initializer_list<T> init_list, const Allocator& _alloc = Allocator());
+        UnrolledList(const UnrolledList& other);
+        UnrolledList(UnrolledList&& other) noexcept;
+
+        ~UnrolledList();
+
+        UnrolledList& operator= (const UnrolledList& other);
+        UnrolledList& operator= (UnrolledList&& other) noexcept;
+
+        // insert and erase shift at most one block, so they are O(1) amortized at a known position,
+        // but unlike My::List they invalidate the iterators into the affected block and its neighbours
+        // emplace() and emplace_front() construct the element in its slot, so args must not refer to elements of the list,
+        // insert() and push_front() take a copy first
+        iterator insert(iterator position, const T& element);
+        iterator insert(iterator position, T&& element);
+        iterator insert(iterator position, int number, const T& element);
+        iterator insert(iterator position, std::initializer_list<T> init_list);
+        iterator erase(iterator first);
+        iterator erase(iterator first, iterator second);
+        template<typename... Args>
+        iterator emplace(iterator position, Args&&... args);
+        void push_back(const T& element);
+        void push_back(T&& element);
+        void push_front(const T& element);
+        void push_front(T&& element);
+        template<typename... Args>
+        T& emplace_back(Args&&... args);
+        template<typename... Args>
+        T& emplace_front(Args&&... args);
+        void pop_back();
+        void pop_front();
+        void resize(int size);
+        void clear();
+        T& front() const noexcept { return static_cast<Node*>(sentinel.next)->data()[0]; }
+        T& back() const noexcept { Node* last = static_cast<Node*>(sentinel.prev); return last->data()[last->count - 1]; }
+        std::size_t size() const noexcept { return sz; }
+        bool empty() const noexcept { return sz == 0; }
+        static constexpr std::size_t block_capacity() noexcept { return capacity; }
+
+        iterator begin() { return iterator(sentinel.next, 0); };
+        iterator end() { return iterator(&sentinel, 0); };
+    };
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    typename UnrolledList<T, BlockBytes, Allocator>::Node* UnrolledList<T, BlockBytes, Allocator>::create_node() {
+        Node* node = spare;
+        if (node) spare = nullptr;
+        else node = NodeTraits::allocate(alloc, 1);
+        node->count = 0;
+        return node;
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    void UnrolledList<T, BlockBytes, Allocator>::destroy_node(Node* node) noexcept {
+        // the elements must have been destroyed before
+        if (!spare) spare = node;
+        else NodeTraits::deallocate(alloc, node, 1);
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    void UnrolledList<T, BlockBytes, Allocator>::take_links(UnrolledList& other) noexcept {
+        spare = other.spare;
+        sz = other.sz;
+        if (other.sentinel.next == &other.sentinel) sentinel.next = sentinel.prev = &sentinel;
+        else {
+            sentinel.next = other.sentinel.next;
+            sentinel.prev = other.sentinel.prev;
+            sentinel.next->prev = &sentinel;
+            sentinel.prev->next = &sentinel;
+        }
+        other.sentinel.next = other.sentinel.prev = &other.sentinel;
+        other.spare = nullptr;
+        other.sz = 0;
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    void UnrolledList<T, BlockBytes, Allocator>::link_after(NodeBase* position, NodeBase* node) noexcept {
+        node->prev = position;
+        node->next = position->next;
+        position->next->prev = node;
+        position->next = node;
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    void UnrolledList<T, BlockBytes, Allocator>::unlink(NodeBase* node) noexcept {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    template<typename... Args>
+    std::pair<typename UnrolledList<T, BlockBytes, Allocator>::Node*, std::size_t> UnrolledList<T, BlockBytes, Allocator>::emplace_impl(NodeBase* position, std::size_t index, Args&&... args) {
+        Node* node;
+        if (position == &sentinel) {
+            // end() is appended to the last block, the element is constructed in place
+            node = static_cast<Node*>(sentinel.prev);
+            bool new_block = position == sentinel.prev || node->count == capacity;
+            if (new_block) node = create_node();
+            try {
+                NodeTraits::construct(alloc, node->data() + node->count, std::forward<Args>(args)...);
+            }
+            catch (...) {
+                if (new_block) destroy_node(node);
+                throw;
+            }
+            if (new_block) link_after(sentinel.prev, node);
+            sz++;
+            return { node, node->count++ };
+        }
+        node = static_cast<Node*>(position);
+        Node* lower = node;
+        Node* upper = nullptr;
+        std::size_t half = capacity / 2;
+
+        if (node->count == capacity) {
+            // split the full block in half, the new element goes into the half that contains index
+            upper = create_node();
+            T* from = node->data();
+            T* to = upper->data();
+            for (std::size_t i = half; i < capacity; i++) {
+                NodeTraits::construct(alloc, to + (i - half), std::move(from[i]));
+                NodeTraits::destroy(alloc, from + i);
+            }
+            upper->count = capacity - half;
+            node->count = half;
+            link_after(node, upper);
+
+            if (index > half) {
+                node = upper;
+                index -= half;
+            }
+        }
+
+        // the gap is opened first and the element is constructed right in it
+        T* data = node->data();
+        for (std::size_t i = node->count; i > index; i--) {
+            NodeTraits::construct(alloc, data + i, std::move(data[i - 1]));
+            NodeTraits::destroy(alloc, data + i - 1);
+        }
+        try {
+            NodeTraits::construct(alloc, data + index, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            // a throwing constructor closes the gap and undoes the split, so the list holds what it held before
+            for (std::size_t i = index; i < node->count; i++) {
+                NodeTraits::construct(alloc, data + i, std::move(data[i + 1]));
+                NodeTraits::destroy(alloc, data + i + 1);
+            }
+            if (upper) {
+                T* to = lower->data();
+                T* from = upper->data();
+                for (std::size_t i = 0; i < upper->count; i++) {
+                    NodeTraits::construct(alloc, to + half + i, std::move(from[i]));
+                    NodeTraits::destroy(alloc, from + i);
+                }
+                lower->count = capacity;
+                unlink(upper);
+                destroy_node(upper);
+            }
+            throw;
+        }
+        node->count++;
+        sz++;
+        return { node, index };
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    UnrolledList<T, BlockBytes, Allocator>::UnrolledList(const Allocator& _alloc) : spare(nullptr), sz(0), alloc(_alloc) {
+        sentinel.next = sentinel.prev = &sentinel;
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    UnrolledList<T, BlockBytes, Allocator>::UnrolledList(std::size_t size, const Allocator& _alloc) : UnrolledList(_alloc) {
+        try {
+            for (std::size_t i = 0; i < size; i++) {
+                emplace_back();
+            }
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    UnrolledList<T, BlockBytes, Allocator>::UnrolledList(std::size_t size, const T& value, const Allocator& _alloc) : UnrolledList(_alloc) {
+        try {
+            for (std::size_t i = 0; i < size; i++) {
+                push_back(value);
+            }
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    UnrolledList<T, BlockBytes, Allocator>::UnrolledList(std::initializer_list<T> init_list, const Allocator& _alloc) : UnrolledList(_alloc) {
+        try {
+            for (auto& el : init_list) {
+                push_back(el);
+            }
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    UnrolledList<T, BlockBytes, Allocator>::UnrolledList(const UnrolledList& other) : UnrolledList(NodeTraits::select_on_container_copy_construction(other.alloc)) {
+        try {
+            for (NodeBase* cur = other.sentinel.next; cur != &other.sentinel; cur = cur->next) {
+                Node* from = static_cast<Node*>(cur);
+                for (std::size_t i = 0; i < from->count; i++) {
+                    push_back(from->data()[i]);
+                }
+            }
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    UnrolledList<T, BlockBytes, Allocator>::UnrolledList(UnrolledList&& other) noexcept : alloc(std::move(other.alloc)) { take_links(other); }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    UnrolledList<T, BlockBytes, Allocator>::~UnrolledList() { clear(); }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    UnrolledList<T, BlockBytes, Allocator>& UnrolledList<T, BlockBytes, Allocator>::operator=(const UnrolledList& other) {
+        if (this != &other) {
+            UnrolledList tmp(other);
+            clear();
+            take_links(tmp);
+        }
+        return *this;
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    UnrolledList<T, BlockBytes, Allocator>& UnrolledList<T, BlockBytes, Allocator>::operator=(UnrolledList&& other) noexcept {
+        if (this != &other) {
+            clear();
+
+            alloc = std::move(other.alloc);
+            take_links(other);
+        }
+        return *this;
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    typename UnrolledList<T, BlockBytes, Allocator>::iterator UnrolledList<T, BlockBytes, Allocator>::insert(iterator position, const T& element) { return emplace(position, T(element)); }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    typename UnrolledList<T, BlockBytes, Allocator>::iterator UnrolledList<T, BlockBytes, Allocator>::insert(iterator position, T&& element) { return emplace(position, std::move(element)); }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    template<typename... Args>
+    typename UnrolledList<T, BlockBytes, Allocator>::iterator UnrolledList<T, BlockBytes, Allocator>::emplace(iterator position, Args&&... args) {
+        auto [node, index] = emplace_impl(position.ptr, position.index(), std::forward<Args>(args)...);
+        return iterator(node, index);
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    typename UnrolledList<T, BlockBytes, Allocator>::iterator UnrolledList<T, BlockBytes, Allocator>::insert(iterator position, int number, const T& element) {
+        if (number < 0) throw std::length_error("length error."); // EXCEPTION
+        if (number == 0) return position;
+
+        // every element goes right after the previous one, the first inserted one is found again by stepping back
+        iterator cur_pos = insert(position, element);
+        for (int i = 1; i < number; i++) {
+            cur_pos = insert(++cur_pos, element);
+        }
+        for (int i = 1; i < number; i++) {
+            --cur_pos;
+        }
+        return cur_pos;
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    typename UnrolledList<T, BlockBytes, Allocator>::iterator UnrolledList<T, BlockBytes, Allocator>::insert(iterator position, std::initializer_list<T> init_list) {
+        if (init_list.size() == 0) return position;
+
+        iterator cur_pos = position;
+        bool first = true;
+        for (auto& el : init_list) {
+            if (!first) ++cur_pos;
+            cur_pos = insert(cur_pos, el);
+            first = false;
+        }
+        for (std::size_t i = 1; i < init_list.size(); i++) {
+            --cur_pos;
+        }
+        return cur_pos;
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    typename UnrolledList<T, BlockBytes, Allocator>::iterator UnrolledList<T, BlockBytes, Allocator>::erase(iterator first) {
+        if (sz == 0 || first.ptr == &sentinel) throw std::out_of_range("unrolled list erase iterator outside range."); // EXCEPTION
+
+        Node* node = static_cast<Node*>(first.ptr);
+        std::size_t index = first.index();
+        T* data = node->data();
+        NodeTraits::destroy(alloc, data + index);
+        for (std::size_t i = index + 1; i < node->count; i++) {
+            NodeTraits::construct(alloc, data + i - 1, std::move(data[i]));
+            NodeTraits::destroy(alloc, data + i);
+        }
+        node->count--;
+        sz--;
+
+        if (node->count == 0) {
+            NodeBase* next = node->next;
+            unlink(node);
+            destroy_node(node);
+            return iterator(next, 0);
+        }
+
+        // a block that drops below half is refilled from its successor, so scans stay dense
+        NodeBase* next = node->next;
+        if (node->count < capacity / 2 && next != &sentinel && node->count + static_cast<Node*>(next)->count <= capacity) {
+            Node* from = static_cast<Node*>(next);
+            T* src = from->data();
+            for (std::size_t i = 0; i < from->count; i++) {
+                NodeTraits::construct(alloc, data + node->count + i, std::move(src[i]));
+                NodeTraits::destroy(alloc, src + i);
+            }
+            node->count += from->count;
+            unlink(from);
+            destroy_node(from);
+        }
+
+        if (index == node->count) return iterator(node->next, 0);
+        return iterator(node, index);
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    typename UnrolledList<T, BlockBytes, Allocator>::iterator UnrolledList<T, BlockBytes, Allocator>::erase(iterator first, iterator second) {
+        if (first == second) return second;
+
+        int offset = 0;
+        for (iterator it = first; it != second; ++it) {
+            offset++;
+        }
+
+        // erase may merge blocks, so the returned iterator is followed instead of second
+        iterator cur_pos = first;
+        for (int i = offset; i > 0; i--) {
+            cur_pos = erase(cur_pos);
+        }
+        return cur_pos;
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    void UnrolledList<T, BlockBytes, Allocator>::push_back(const T& element) { emplace_back(element); }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    void UnrolledList<T, BlockBytes, Allocator>::push_back(T&& element) { emplace_back(std::move(element)); }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    void UnrolledList<T, BlockBytes, Allocator>::push_front(const T& element) { emplace_front(T(element)); }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    void UnrolledList<T, BlockBytes, Allocator>::push_front(T&& element) { emplace_front(std::move(element)); }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    template<typename... Args>
+    T& UnrolledList<T, BlockBytes, Allocator>::emplace_back(Args&&... args) {
+        auto [node, index] = emplace_impl(&sentinel, 0, std::forward<Args>(args)...);
+        return node->data()[index];
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    template<typename... Args>
+    T& UnrolledList<T, BlockBytes, Allocator>::emplace_front(Args&&... args) {
+        auto [node, index] = emplace_impl(sentinel.next, 0, std::forward<Args>(args)...);
+        return node->data()[index];
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    void UnrolledList<T, BlockBytes, Allocator>::pop_back() {
+        if (!sz) throw std::out_of_range("pop_back called on empty unrolled list."); // EXCEPTION
+        Node* last = static_cast<Node*>(sentinel.prev);
+        erase(iterator(last, last->count - 1));
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    void UnrolledList<T, BlockBytes, Allocator>::pop_front() {
+        if (!sz) throw std::out_of_range("pop_front called on empty unrolled list."); // EXCEPTION
+        erase(begin());
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    void UnrolledList<T, BlockBytes, Allocator>::resize(int size) {
+        if (size < 0) throw std::length_error("length error."); // EXCEPTION
+        while (sz < static_cast<std::size_t>(size)) {
+            emplace_back();
+        }
+        while (sz > static_cast<std::size_t>(size)) {
+            pop_back();
+        }
+    }
+
+    template<typename T, std::size_t BlockBytes, typename Allocator>
+    void UnrolledList<T, BlockBytes, Allocator>::clear() {
+        NodeBase* cur = sentinel.next;
+        while (cur != &sentinel) {
+            NodeBase* forward = cur->next;
+            Node* node = static_cast<Node*>(cur);
+            for (std::size_t i = 0; i < node->count; i++) {
+                NodeTraits::destroy(alloc, node->data() + i);
+            }
+            NodeTraits::deallocate(alloc, node, 1);
+            cur = forward;
+        }
+        if (spare) NodeTraits::deallocate(alloc, spare, 1);
+        spare = nullptr;
+        sentinel.next = sentinel.prev = &sentinel;
+        sz = 0;
+    }
+}
+
+#endif // !__UNROLLED_LIST_HPP__
\ No newline at end of file
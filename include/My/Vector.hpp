@@ -9,6 +9,9 @@
 #include <utility>
 #include <initializer_list>
 #include <memory>
+#include <iterator>
+#include <cstddef>
+#include "Counters.hpp"
 
 namespace My {
     template<typename T, typename Allocator = std::allocator<T>>
@@ -17,11 +20,18 @@ namespace My {
         std::size_t sz; // size
         T* data;
         Allocator alloc;
+        [[no_unique_address]] InstanceCounters counter;
 
     public:
         class iterator {
             T* ptr;
         public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
             iterator() = default;
             iterator(T* _ptr) : ptr(_ptr) {}
             T& operator*() const noexcept { return *ptr; }
@@ -40,6 +50,7 @@ namespace My {
             iterator operator-(int offset) const noexcept { iterator tmp = *this; tmp.ptr -= offset; return tmp; }
             iterator& operator+=(int offset) noexcept { ptr += offset; return *this; }
             iterator& operator-=(int offset) noexcept { ptr -= offset; return *this; }
+            difference_type operator-(const iterator& second) const noexcept { return ptr - second.ptr; }
         };
 
         Vector(const Allocator& _alloc = Allocator());
@@ -71,6 +82,8 @@ namespace My {
         T& front() const;
         T& back() const;
         T& at(std::size_t index) const;
+        Counters counters() const noexcept { return counter.get(); } // zeros unless MY_CONTAINERS_STATS is defined
+        void reset_counters() noexcept { counter.reset(); }
 
         iterator begin() { return iterator(data); };
         iterator end() { return iterator(data + sz); };
@@ -79,6 +92,7 @@ namespace My {
     template<typename T, typename Allocator>
     Vector<T, Allocator>::Vector(const Allocator& _alloc) : sz(0), cp(1), alloc(_alloc) {
         data = alloc.allocate(cp);
+        counter.allocation();
     }
 
     template<typename T, typename Allocator>
@@ -87,6 +101,7 @@ namespace My {
         if (sz == 0) cp++;
 
         data = alloc.allocate(cp);
+        counter.allocation();
         for (std::size_t i = 0; i < sz; i++) {
             std::allocator_traits<Allocator>::construct(alloc, data + i);
         }
@@ -95,27 +110,33 @@ namespace My {
     template<typename T, typename Allocator>
     Vector<T, Allocator>::Vector(std::initializer_list<T> init_list, const Allocator& _alloc) : sz(init_list.size()), cp(init_list.size()), alloc(_alloc) {
         data = alloc.allocate(cp);
+        counter.allocation();
         std::size_t index = 0;
         for (auto& el : init_list) {
             std::allocator_traits<Allocator>::construct(alloc, data + index++, el);
         }
+        counter.copy(sz);
     }
 
     template<typename T, typename Allocator>
     Vector<T, Allocator>::Vector(std::size_t size, const T& value, const Allocator& _alloc) : sz(size), cp(size), alloc(_alloc) {
         data = alloc.allocate(cp);
+        counter.allocation();
         for (std::size_t i = 0; i < sz; i++) {
             std::allocator_traits<Allocator>::construct(alloc, data + i, value);
         }
+        counter.copy(sz);
     }
 
     template<typename T, typename Allocator>
     Vector<T, Allocator>::Vector(const Vector& other) : sz(other.sz), cp(other.cp), alloc(other.alloc) {
         if (other.data) {
             data = alloc.allocate(cp);
+            counter.allocation();
             for (std::size_t i = 0; i < sz; i++) {
                 std::allocator_traits<Allocator>::construct(alloc, data + i, other.data[i]);
             }
+            counter.copy(sz);
         }
         else {
             data = nullptr;
@@ -144,9 +165,11 @@ namespace My {
             alloc = other.alloc;
             if (other.data) {
                 data = alloc.allocate(cp);
+                counter.allocation();
                 for (std::size_t i = 0; i < sz; i++) {
                     std::allocator_traits<Allocator>::construct(alloc, data + i, other.data[i]);
                 }
+                counter.copy(sz);
             }
             else {
                 data = nullptr;
@@ -183,9 +206,12 @@ namespace My {
             cp *= 2;
 
             T* new_data = alloc.allocate(cp);
+            counter.allocation();
+            counter.reallocation();
             for (std::size_t i = 0; i < old_capacity; i++) {
                 std::allocator_traits<Allocator>::construct(alloc, new_data + i, data[i]);
             }
+            counter.copy(old_capacity);
             for (std::size_t i = 0; i < old_capacity; i++) {
                 std::allocator_traits<Allocator>::destroy(alloc, data + i);
             }
@@ -193,6 +219,7 @@ namespace My {
             data = new_data;
         }
         std::allocator_traits<Allocator>::construct(alloc, data + sz - 1, element);
+        counter.copy();
     }
 
     template<typename T, typename Allocator>
@@ -218,6 +245,7 @@ namespace My {
             *it = *(it - 1);
         }
         *position = element;
+        counter.copy(end() - position + 1); // last, the shifted elements and element, push_back() counts its own copy
         push_back(last);
         return iterator(begin() + offset);
     }
@@ -249,6 +277,7 @@ namespace My {
         for (iterator it = first; it != end() - 1; ++it) {
             *it = *(it + 1);
         }
+        counter.copy(end() - first - 1);
         std::allocator_traits<Allocator>::destroy(alloc, data + --sz);
         return first;
     }
@@ -284,9 +313,12 @@ namespace My {
             cp = sz;
 
             T* new_data = alloc.allocate(cp);
+            counter.allocation();
+            counter.reallocation();
             for (std::size_t i = 0; i < old_size; i++) {
                 std::allocator_traits<Allocator>::construct(alloc, new_data + i, data[i]);
             }
+            counter.copy(old_size);
             for (std::size_t i = 0; i < old_size; i++) {
                 std::allocator_traits<Allocator>::destroy(alloc, data + i);
             }
@@ -306,9 +338,12 @@ namespace My {
             cp = capacity;
 
             T* new_data = alloc.allocate(cp);
+            counter.allocation();
+            counter.reallocation();
             for (std::size_t i = 0; i < sz; i++) {
                 std::allocator_traits<Allocator>::construct(alloc, new_data + i, data[i]);
             }
+            counter.copy(sz);
             for (std::size_t i = 0; i < sz; i++) {
                 std::allocator_traits<Allocator>::destroy(alloc, data + i);
             }